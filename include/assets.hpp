@@ -1,12 +1,26 @@
 #pragma once
 #include "../glad/glad.h"
+#include "atlas.hpp"
 #include <vector>
 
+// Layers of GameAssets::tileSprites.
+enum TileSprite : uint8_t {
+  SPRITE_CLOSED,
+  SPRITE_HOVER,
+  SPRITE_MINE,
+  SPRITE_MINE_RED,
+  SPRITE_FLAG,
+  SPRITE_WRONG_FLAG,
+  SPRITE_NUMBER,                     // + 0-8
+  SPRITE_YELLOW = SPRITE_NUMBER + 9, // + 0-8
+  SPRITE_COUNT = SPRITE_YELLOW + 9,
+};
+
+// Everything but the tiles lives in one atlas texture.
 struct GameAssets {
-  GLuint closed, hover, mine, mineRed, flag, wrongFlag;
-  std::vector<GLuint> numbers;
-  std::vector<GLuint> yellowNumbers;
-  std::vector<GLuint> digits;
-  GLuint faceHappy, faceO, faceDead, faceWin;
-  GLuint borderH, borderV, cornerTL, cornerTR, cornerBL, cornerBR;
+  GLuint tileSprites;
+  GLuint atlas;
+  std::vector<UVRect> digits;
+  UVRect faceHappy, faceO, faceDead, faceWin;
+  UVRect borderH, borderV, cornerTL, cornerTR, cornerBL, cornerBR;
 };
@@ -0,0 +1,42 @@
+#pragma once
+#include "../glad/glad.h"
+#include <string>
+#include <vector>
+
+// Sub-rectangle of a texture in texture coordinates.
+struct UVRect {
+  float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+};
+
+// Packs images into one texture on shelves at startup. Each image sits in a
+// gutter of its own edge texels and starts on a kAlign boundary, so linear
+// filtering and the first mip levels never sample a neighbour.
+class TextureAtlas {
+public:
+  static const int kGutter = 4;
+  static const int kAlign = 4;
+  // Mip levels past this would shrink the gutter below one texel.
+  static const int kMaxLevel = 2;
+
+  // w and h as for loadImage; returns the id to pass to uv().
+  int add(const std::string &path, int w = 0, int h = 0);
+  // Packs and uploads everything added; returns 0 if nothing was loaded.
+  GLuint build();
+  const UVRect &uv(int id) const { return entries[id].uv; }
+
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+
+private:
+  struct Entry {
+    std::vector<unsigned char> pixels;
+    int w = 0, h = 0, x = 0, y = 0;
+    UVRect uv;
+  };
+
+  void pack();
+
+  std::vector<Entry> entries;
+  int width = 0;
+  int height = 0;
+};
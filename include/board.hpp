@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+enum class GameState { PLAYING, WON, LOST };
+enum class RevealResult { CONTINUE, GAME_OVER, WIN };
+enum class Difficulty { BEGINNER, INTERMEDIATE, EXPERT };
+
+// The board each difficulty plays on, shared by the game and the headless
+// tools; the mine count is Board::defaultMineCount(rows, cols).
+struct DifficultyLevel {
+  const char *name;
+  int rows, cols;
+};
+const DifficultyLevel &difficultyLevel(Difficulty d);
+
+struct Cell {
+  bool mine;
+  bool revealed;
+  bool flagged;
+  uint8_t adjacent;
+};
+
+struct Move {
+  int index;
+  bool flag;
+};
+
+class Board;
+
+enum : int8_t { CELL_UNKNOWN = -1, CELL_FLAGGED = -2 };
+
+// Byte encoding of a cell for bot interfaces: 0-8 for a revealed number,
+// otherwise one of these.
+enum : uint8_t { CODE_HIDDEN = 9, CODE_FLAGGED = 10, CODE_MINE = 11 };
+
+// What a player can see: 0-8 for revealed cells, CELL_UNKNOWN or
+// CELL_FLAGGED otherwise. Flags are trusted as mines.
+struct BoardView {
+  int rows = 0;
+  int cols = 0;
+  int mines = 0;
+  std::vector<int8_t> cells;
+
+  static BoardView of(const Board &board);
+};
+
+// Minesweeper rules without any GL or window state, so the board can be
+// copied to solver threads and driven headlessly.
+class Board {
+public:
+  static int defaultMineCount(int rows, int cols);
+
+  void reset(int rows, int cols, int mines, uint64_t seed);
+
+  // Mines are placed lazily on the first reveal so the clicked cell and its
+  // neighbours are always safe.
+  void generate(int safeIndex);
+  void placeMines(const std::vector<int> &mineIndices);
+
+  RevealResult reveal(int index);
+  bool toggleFlag(int index);
+  // Reveals the unflagged neighbours of a revealed number whose flags
+  // already account for all its mines.
+  RevealResult chord(int index);
+
+  // When on, every cell whose revealed or flagged state changes is appended
+  // to getChanges() until clearChanges().
+  void setTrackChanges(bool on) { trackChanges = on; }
+  bool isTrackingChanges() const { return trackChanges; }
+  const std::vector<int> &getChanges() const { return changes; }
+  void clearChanges() { changes.clear(); }
+
+  int getRows() const { return rows; }
+  int getCols() const { return cols; }
+  int getMineCount() const { return mines; }
+  int getFlaggedCount() const { return flagged; }
+  int size() const { return (int)cells.size(); }
+  bool isGenerated() const { return generated; }
+  GameState getState() const { return state; }
+
+  const Cell &at(int index) const { return cells[index]; }
+  uint8_t code(int index) const;
+
+private:
+  void computeAdjacency();
+
+  int rows = 0;
+  int cols = 0;
+  int mines = 0;
+  int flagged = 0;
+  int revealedCount = 0;
+  uint64_t seed = 0;
+  bool generated = false;
+  bool trackChanges = false;
+  GameState state = GameState::PLAYING;
+  std::vector<Cell> cells;
+  std::vector<int> stack;
+  std::vector<int> changes;
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include "board.hpp"
+#include "guessEngine.hpp"
+#include "solver.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+
+// Plays a Board using only what a player can see. LOCAL applies the two
+// single-number rules and otherwise guesses the cell with the lowest local
+// mine density. SOLVER falls back to the frontier solver when the simple
+// rules are stuck and guesses the cell it rates least likely to be a mine.
+// EXPECTIMAX deduces like SOLVER but hands guesses to the GuessEngine, which
+// rates them by expected win probability.
+class Bot {
+public:
+  enum class Policy { LOCAL, SOLVER, EXPECTIMAX };
+
+  explicit Bot(Policy policy = Policy::LOCAL);
+
+  // Appends every move the bot is sure of, or a single guess if there are
+  // none. Returns false once the game is over.
+  bool nextMoves(const Board &board, std::mt19937_64 &rng,
+                 std::vector<Move> &out);
+
+  // Plays until the game ends; returns true on a win.
+  bool play(Board &board, std::mt19937_64 &rng);
+
+private:
+  int guessLocal(const Board &board, std::mt19937_64 &rng);
+
+  Policy policy;
+  Solver solver;
+  // Only built for EXPECTIMAX; runs single-threaded, one bot per worker.
+  std::unique_ptr<GuessEngine> guesser;
+  SolveResult solved;
+  std::vector<Move> moves;
+  std::vector<float> risk;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include "board.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Headless bot interface served by `main --bot` (text) or `--bot-binary`.
+// Every message may hold many commands, and each message gets one reply
+// listing only the cells that changed while it ran.
+//
+// Text: a message is one line of ';'-separated commands
+//   n ROWS COLS MINES SEED   new game
+//   r I / f I / c I          reveal, toggle flag or chord cell I (row-major)
+//   d                        append the whole board to the reply
+// Reply: `ok|err STATE K I:V ...` with STATE none/playing/won/lost and V
+// one of 0-8, '.' hidden, 'F' flagged or '*' mine, then `board ROWS COLS
+// MINES CELLS` after a dump. Processing stops at the first bad command and
+// the reply ends with `# N: reason`.
+//
+// Binary: a message is a little-endian u32 payload length followed by
+// commands, each an opcode byte and its arguments
+//   1 new    u16 rows, u16 cols, u16 mines, u64 seed
+//   2 reveal, 3 flag, 4 chord    u32 cell
+//   5 dump
+// Reply: u32 length, u8 status (0, or the 1-based failing command), u8
+// state (0 playing, 1 won, 2 lost), u32 K, K x (u32 cell, u8 value) with
+// 9 hidden, 10 flagged and 11 mine, then u8 hasBoard and, if set, u16 rows,
+// u16 cols, u16 mines and one value byte per cell.
+class BotProtocol {
+public:
+  enum class Mode { TEXT, BINARY };
+
+  explicit BotProtocol(Mode mode) : mode(mode) {}
+
+  // Serves messages until end of input; returns the process exit code.
+  int run(FILE *in, FILE *out);
+
+private:
+  enum Op : uint8_t { NEW = 1, REVEAL = 2, FLAG = 3, CHORD = 4, DUMP = 5 };
+
+  struct Command {
+    Op op;
+    int cell;
+    int rows, cols, mines;
+    uint64_t seed;
+  };
+
+  bool parseText(const std::string &line, std::vector<Command> &out,
+                 std::string &error);
+  bool parseBinary(const std::vector<uint8_t> &payload,
+                   std::vector<Command> &out);
+  // Runs cmds in order; returns the index of the first failing one, or -1.
+  int execute(const std::vector<Command> &list, bool &dumped);
+  void collectChanges();
+
+  void replyText(FILE *out, int failed, const std::string &error,
+                 bool dumped);
+  void replyBinary(FILE *out, int failed, bool dumped);
+
+  Mode mode;
+  Board board;
+  bool started = false;
+  std::vector<int> changed;
+  std::vector<uint8_t> marked;
+  std::vector<Command> cmds;
+  std::string text;
+  std::vector<uint8_t> bytes;
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <chrono>
+
+// Source of game time in seconds. The game only ever subtracts readings, so
+// the origin is up to the implementation.
+class GameClock {
+public:
+  virtual ~GameClock() = default;
+  virtual double now() const = 0;
+};
+
+// Wall time from a monotonic source; the default for interactive play.
+class MonotonicClock : public GameClock {
+public:
+  double now() const override {
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now() - origin)
+        .count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point origin =
+      std::chrono::steady_clock::now();
+};
+
+// Time that only moves when told to, for replays that restore recorded
+// timestamps and for tests that need exact elapsed times.
+class ManualClock : public GameClock {
+public:
+  double now() const override { return t; }
+  void set(double seconds) { t = seconds; }
+  void advance(double seconds) { t += seconds; }
+
+private:
+  double t = 0.0;
+};
+
+// Simulated time advancing a fixed step per tick, so headless runs go as
+// fast as the CPU allows and report the same timings every run. The
+// shared-memory host (`main --bot-shm`) ticks once per bot command.
+class VirtualClock : public GameClock {
+public:
+  explicit VirtualClock(double stepSeconds = 1.0 / 60.0) : step(stepSeconds) {}
+  double now() const override { return ticks * step; }
+  void tick(long n = 1) { ticks += n; }
+
+private:
+  double step;
+  long ticks = 0;
+};
@@ -64,6 +64,35 @@ struct Config {
     float fontSize = 24.0f;
     float fontScaleCorrection = 0.8f;
   } ui;
+
+  struct Render {
+    // Edge length of each layer in the tile sprite array.
+    int tileSpriteSize = 128;
+    // Print the GL state cache's issued/elided counts once a second.
+    bool logStateStats = false;
+    // Stream vertex data through persistently mapped buffers when GL 4.4
+    // is available; off forces the buffer-orphaning path.
+    bool persistentBuffers = true;
+    // Print a timestamp for every drawn frame and the idle wakeups skipped
+    // since the previous one.
+    bool logFrames = false;
+  } render;
+
+  struct Hints {
+    long maxSolverNodes = 2000000;
+    float safeTint[4] = {0.2f, 0.8f, 0.2f, 0.45f};
+    float guessTint[4] = {0.9f, 0.8f, 0.1f, 0.45f};
+    float heatmapAlpha = 0.5f;
+  } hints;
+
+  struct Bots {
+    // Shared-memory segment to publish the board in, e.g. "/minesweeper";
+    // empty disables it.
+    std::string sharedName;
+    int sharedMaxCells = 1 << 16;
+    // How often an idle game checks the segment for bot commands.
+    double sharedPollSeconds = 0.005;
+  } bots;
 };
 
 extern Config cfg;
@@ -1,21 +1,35 @@
 #pragma once
 #include "../glad/glad.h"
 #include "assets.hpp"
+#include "board.hpp"
+#include "clock.hpp"
+#include "glState.hpp"
+#include "gridRenderer.hpp"
+#include "heatmap.hpp"
+#include "projection.hpp"
+#include "quadMesh.hpp"
 #include "renderer.hpp"
+#include "sharedBoard.hpp"
+#include "solverWorker.hpp"
 #include "textRenderer.hpp"
 #include "window.hpp"
+#include <cstdint>
+#include <memory>
 #include <vector>
 
-enum class GameState { PLAYING, WON, LOST };
-enum class Difficulty { BEGINNER, INTERMEDIATE, EXPERT };
-enum class RevealResult { CONTINUE, GAME_OVER, WIN };
-
 struct Tile {
   float x, y, w, h;
-  char symbol;
-  bool revealed;
-  bool flagged;
-  GLuint texture;
+  uint8_t sprite; // TileSprite
+};
+
+// Screen positions that depend only on the window size.
+struct UILayout {
+  float scale = 1.0f;
+  float headerH = 0.0f, menuH = 0.0f, borderTh = 0.0f, faceSize = 0.0f;
+  float menuBtnW = 0.0f, gridTop = 0.0f;
+  float faceX = 0.0f, faceY = 0.0f;
+  float counterY = 0.0f, mineCounterX = 0.0f, timerX = 0.0f;
+  float textScale = 1.0f, textY = 0.0f;
 };
 
 struct GameContext {
@@ -28,11 +42,14 @@ struct GameContext {
   double finalTime = 0.0;
   bool gameStarted = false;
   bool leftMouseHeld = false;
+  bool showHints = false;
+  bool showHeatmap = false;
 };
 
 class MinesweeperGame {
 public:
-  MinesweeperGame();
+  // clock defaults to wall time; a caller-owned clock must outlive the game.
+  explicit MinesweeperGame(GameClock *clock = nullptr);
   ~MinesweeperGame();
 
   void init();
@@ -43,33 +60,82 @@ public:
 
   void handleInput(Window &window);
 
+  // True if anything on screen changed since the last call: input, hover,
+  // the board, hints or the displayed time.
+  bool needsRedraw(Window &window);
+  // Seconds until the screen changes without input; negative if only
+  // input can change it.
+  double idleTimeout() const;
+
 private:
+  struct FrameKey {
+    int width = 0, height = 0;
+    double mx = 0.0, my = 0.0;
+    bool leftHeld = false, showHints = false, showHeatmap = false;
+    GameState state = GameState::PLAYING;
+    uint64_t boardVersion = 0;
+    int seconds = 0;
+    const SolveResult *hints = nullptr;
+
+    bool operator==(const FrameKey &o) const;
+  };
+
+  double elapsedSeconds() const;
+  int displayedSeconds() const;
+
   void setDifficulty(Difficulty d);
   void computeTileLayout(int windowWidth, int windowHeight, float headerHeight,
                          float menuHeight, float borderThickness);
   void resetBoard();
-  RevealResult revealTileAt(int index);
+  void syncTileTextures();
   void processGameOver(int clickedIndex);
-  void generateGameOnFirstClick(int safeIndex, int totalMines);
-  int countNeighborMines(int r, int c);
-  void setTileContent(Tile &t, char symbol);
-  int getFlaggedCount() const;
+  void onBoardChanged();
+  void revealCell(int idx, bool chord);
+  void flagCell(int idx);
+  void applySharedCommands();
+  void updateHintMarks();
   bool isPointInsideRect(float px, float py, float x, float y, float w,
                          float h);
 
   void drawCounter(float x, float y, int value, float scale);
-  void drawBorderFrame(float x, float y, float w, float h, float th);
+  void addBorderFrame(float x, float y, float w, float h, float th);
+  void updateLayout(int width, int height);
 
+  MonotonicClock monotonicClock;
+  GameClock *clock;
   GameContext ctx;
+  Board board;
   std::vector<Tile> tiles;
   GameAssets assets;
 
+  ProjectionBuffer projection;
   Renderer renderer;
+  GridRenderer gridRenderer;
+  QuadMesh chrome;
   TextRenderer textRenderer;
   GLuint shaderProgram;
 
+  SolverWorker solverWorker;
+  uint64_t boardVersion = 0;
+  std::shared_ptr<const SolveResult> hintResult;
+  uint64_t hintMarksVersion = 0;
+  uint64_t hintMarksSerial = 0;
+  std::vector<uint8_t> hintMarks;
+  std::vector<int> dirtyTiles;
+  bool gridFullRefresh = true;
+  uint64_t gridMarksSerial = 0;
+  bool gridShowMarks = false;
+  Heatmap heatmap;
+  uint64_t heatmapVersion = 0;
+  SharedBoardHost sharedHost;
+
   bool lastLeftMouseState = false;
   bool lastRightMouseState = false;
+  bool lastHintKeyState = false;
+  bool lastHeatmapKeyState = false;
   int lastWidth = 0;
   int lastHeight = 0;
+  UILayout layout;
+  double lastStatsLog = 0.0;
+  FrameKey lastFrame;
 };
@@ -0,0 +1,51 @@
+#pragma once
+#include "../glad/glad.h"
+#include <string>
+#include <unordered_map>
+
+// Shadows the GL bindings the game changes so binds that match the current
+// state are skipped, and caches uniform locations per program. Programs,
+// vertex arrays and textures must be bound and deleted through it, or the
+// shadow state goes stale.
+class GLStateCache {
+public:
+  struct Stats {
+    int issued = 0;
+    int elided = 0;
+  };
+
+  void useProgram(GLuint prog);
+  void bindVertexArray(GLuint vao);
+  void bindTexture(GLenum target, GLuint tex, int unit = 0);
+
+  void deleteProgram(GLuint prog);
+  void deleteVertexArray(GLuint vao);
+  void deleteTexture(GLuint tex);
+
+  // Records the location of every active uniform; call after linking.
+  void cacheUniforms(GLuint prog);
+  GLint uniform(GLuint prog, const char *name);
+
+  // Starts a new frame's counters; lastFrame() then holds the previous one.
+  void beginFrame();
+  const Stats &lastFrame() const { return last; }
+
+private:
+  static const int kUnits = 4;
+
+  struct Unit {
+    GLuint tex2D = 0;
+    GLuint tex2DArray = 0;
+  };
+
+  bool changed(bool differs);
+
+  GLuint program = 0;
+  GLuint vertexArray = 0;
+  int activeUnit = 0;
+  Unit units[kUnits];
+  std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> uniforms;
+  Stats current, last;
+};
+
+extern GLStateCache glState;
@@ -0,0 +1,41 @@
+#pragma once
+#include "../glad/glad.h"
+#include <cstdint>
+#include <vector>
+
+// Draws the whole grid as one quad. Each cell is one texel of an R8UI state
+// texture holding its sprite layer and tint, and the fragment shader picks
+// the sprite under each pixel, so the draw costs the same for any board
+// size. Changed cells are tracked as a span per row, and each run of
+// consecutive dirty rows goes up in one glTexSubImage2D.
+class GridRenderer {
+public:
+  enum Tint : uint8_t { TINT_NONE, TINT_SAFE, TINT_GUESS };
+
+  ~GridRenderer();
+
+  void init();
+  GLuint getProgram() const { return program; }
+
+  // Reallocates the state texture if the size changed; cells start closed.
+  void resize(int rows, int cols);
+  void set(int index, uint8_t sprite, Tint tint = TINT_NONE);
+
+  // hoverCell shows as pressed if it is closed; -1 for none. Tint colours
+  // blend rgb over the sprite by alpha.
+  void draw(GLuint spriteArray, float x, float y, float cellSize,
+            int hoverCell, const float safeTint[4],
+            const float guessTint[4]);
+
+private:
+  void upload();
+
+  GLuint program = 0;
+  GLuint vao = 0, vbo = 0;
+  GLuint cellTex = 0;
+  int rows = 0, cols = 0;
+  std::vector<uint8_t> cells;
+  // Dirty columns [spanMin, spanMax] of each row; spanMax < 0 when clean.
+  std::vector<int> spanMin, spanMax;
+  int dirtyY0 = 0, dirtyY1 = -1;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include "solver.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct GuessOptions {
+  int depth = 2;
+  // Lowest-probability cells expanded at the root and below it.
+  int rootCandidates = 6;
+  int innerCandidates = 3;
+  // Threads evaluating root candidates; 0 uses every core.
+  int threads = 0;
+  long maxSolverNodes = 200000;
+};
+
+struct GuessEvaluation {
+  int cell;
+  double safeProbability;
+  // Estimated probability of winning if this cell is guessed now.
+  double winProbability;
+};
+
+// Picks a guess by expected win probability rather than by lowest mine
+// probability alone: each candidate is expanded over every number it could
+// reveal, weighted by how many layouts produce it, and the resulting
+// positions are searched again up to the configured depth.
+class GuessEngine {
+public:
+  explicit GuessEngine(const GuessOptions &opts = GuessOptions());
+
+  // Returns the chosen cell, or -1 if the view has no unknown cells.
+  // evals, if given, receives every root candidate best first.
+  int choose(const BoardView &view,
+             std::vector<GuessEvaluation> *evals = nullptr);
+
+  void clearCache();
+  long getCacheHits() const { return hits.load(); }
+  long getCacheMisses() const { return misses.load(); }
+
+private:
+  static const int kShards = 16;
+
+  struct Shard {
+    std::mutex mtx;
+    std::unordered_map<std::string, double> values;
+  };
+
+  double value(const BoardView &view, int depth, Solver &solver,
+               const SolveResult *solved = nullptr);
+  double expand(const BoardView &view, int cell, double safeProbability,
+                int depth, Solver &solver);
+  std::vector<int> candidates(const BoardView &view, const SolveResult &res,
+                              int count) const;
+
+  bool lookup(const std::string &key, double &out);
+  void store(const std::string &key, double v);
+
+  GuessOptions opts;
+  Shard shards[kShards];
+  std::atomic<long> hits;
+  std::atomic<long> misses;
+};
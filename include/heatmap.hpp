@@ -0,0 +1,23 @@
+#pragma once
+#include "../glad/glad.h"
+#include "solver.hpp"
+#include <vector>
+
+// One texel per cell, tinted by mine probability and drawn as a single quad
+// over the grid. Only the rectangle of texels that changed is re-uploaded.
+class Heatmap {
+public:
+  ~Heatmap();
+
+  void init();
+  void update(const SolveResult &result, int rows, int cols);
+
+  GLuint getTexture() const { return tex; }
+
+private:
+  GLuint tex = 0;
+  int rows = 0;
+  int cols = 0;
+  std::vector<unsigned char> pixels;
+  std::vector<unsigned char> next;
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include "board.hpp"
+#include <cstdint>
+#include <vector>
+
+// kLanes independent games of the same size stepped in lockstep. State is
+// stored as struct-of-arrays byte planes with cell i of lane l at
+// plane[i * kLanes + l], so per-cell work across games is one contiguous
+// kLanes-byte run that the compiler turns into a single vector operation.
+// Mines come from a counter-based hash of the lane's seed and the cell
+// index rather than Board's mt19937_64 stream, so placement also runs
+// across lanes; layout() reproduces a lane's mines one board at a time.
+class LaneBoard {
+public:
+  static const int kLanes = 16;
+
+  void reset(int rows, int cols, int mines, const uint64_t seeds[kLanes]);
+  void resetLane(int lane, uint64_t seed);
+
+  // Applies actions[l] to lane l. A negative index leaves the lane alone, as
+  // do lanes whose game is over. Lanes revealing for the first time have
+  // their mines placed together before any action is applied.
+  void step(const Move actions[kLanes], RevealResult results[kLanes]);
+
+  int getRows() const { return rows; }
+  int getCols() const { return cols; }
+  int getMineCount() const { return mines; }
+  int size() const { return rows * cols; }
+  GameState getState(int lane) const { return (GameState)state[lane]; }
+  int getRevealedCount(int lane) const { return revealedCount[lane]; }
+  int countPlaying() const;
+
+  bool isMine(int lane, int i) const { return mine[i * kLanes + lane]; }
+  bool isRevealed(int lane, int i) const {
+    return revealed[i * kLanes + lane];
+  }
+  bool isFlagged(int lane, int i) const { return flagged[i * kLanes + lane]; }
+  int adjacentMines(int lane, int i) const {
+    return adjacent[i * kLanes + lane];
+  }
+
+  BoardView view(int lane) const;
+
+  // Scalar reference for the mines a lane seeded with seed gets when its
+  // first reveal is safeIndex; feed the result to Board::placeMines to
+  // replay the game on a Board.
+  static void layout(int rows, int cols, int mines, uint64_t seed,
+                     int safeIndex, std::vector<int> &mineIndices);
+
+private:
+  void setSeed(int lane, uint64_t seed);
+  // Places mines for every lane with safeIndex[l] >= 0.
+  void generate(const int safeIndex[kLanes]);
+  void computeAdjacency();
+  void addAdjacency(int lane);
+  RevealResult reveal(int lane, int index);
+
+  int rows = 0;
+  int cols = 0;
+  int mines = 0;
+  uint32_t key0[kLanes] = {};
+  uint32_t key1[kLanes] = {};
+  int revealedCount[kLanes] = {};
+  int flaggedCount[kLanes] = {};
+  uint8_t generated[kLanes] = {};
+  uint8_t state[kLanes] = {};
+  int pending[kLanes] = {};
+  std::vector<uint8_t> mine;
+  std::vector<uint8_t> revealed;
+  std::vector<uint8_t> flagged;
+  std::vector<uint8_t> adjacent;
+  std::vector<int> stack;
+};
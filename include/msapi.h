@@ -0,0 +1,95 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Stable C interface to the board engine for embedding from other runtimes.
+// Boards are opaque handles; every output goes into memory the caller
+// provides, and nothing returned needs freeing except the handle itself.
+// Batch calls apply many moves, or one move on many boards, per call so the
+// per-call FFI cost is paid once.
+//
+// Bump MS_API_MINOR for additions and MS_API_MAJOR for any change that
+// breaks existing callers; check ms_api_version() against the header.
+
+#define MS_API_MAJOR 1
+#define MS_API_MINOR 1
+#define MS_API_VERSION ((MS_API_MAJOR << 16) | MS_API_MINOR)
+
+// Largest board, in cells, that ms_board_new and ms_board_reset accept.
+#define MS_MAX_CELLS (1 << 24)
+
+typedef struct ms_board ms_board;
+
+enum {
+  MS_ERROR = -1,
+  MS_CONTINUE = 0,
+  MS_GAME_OVER = 1,
+  MS_WIN = 2,
+};
+
+enum { MS_PLAYING = 0, MS_WON = 1, MS_LOST = 2 };
+
+enum { MS_MOVE_REVEAL = 0, MS_MOVE_FLAG = 1, MS_MOVE_CHORD = 2 };
+
+// Snapshot bytes: 0-8 for revealed numbers, otherwise one of these.
+enum { MS_CELL_HIDDEN = 9, MS_CELL_FLAGGED = 10, MS_CELL_MINE = 11 };
+
+typedef struct {
+  int32_t cell;
+  int32_t kind; // MS_MOVE_*
+} ms_move;
+
+typedef struct {
+  int32_t rows;
+  int32_t cols;
+  int32_t mines;
+  int32_t flags;
+  int32_t state; // MS_PLAYING / MS_WON / MS_LOST
+} ms_info;
+
+uint32_t ms_api_version(void);
+
+// Mines are placed on the first reveal, around which the board is safe.
+// Returns NULL if the size is not positive, exceeds MS_MAX_CELLS, or cannot
+// be allocated; ms_board_reset returns MS_ERROR in the same cases. No C++
+// exception escapes any of these functions.
+ms_board *ms_board_new(int32_t rows, int32_t cols, int32_t mines,
+                       uint64_t seed);
+void ms_board_free(ms_board *board);
+int ms_board_reset(ms_board *board, int32_t rows, int32_t cols,
+                   int32_t mines, uint64_t seed);
+int ms_board_info(const ms_board *board, ms_info *out);
+
+// Single moves return MS_CONTINUE, MS_GAME_OVER, MS_WIN or MS_ERROR for a
+// cell out of range. Flagging returns MS_CONTINUE.
+int ms_reveal(ms_board *board, int32_t cell);
+int ms_flag(ms_board *board, int32_t cell);
+int ms_chord(ms_board *board, int32_t cell);
+
+// Applies moves[0..n-1] in order, stopping once the game ends. results, if
+// not NULL, receives one result per applied move. Returns the number of
+// moves applied.
+int ms_reveal_batch(ms_board *board, const ms_move *moves, int32_t n,
+                    int8_t *results);
+
+// Applies moves[i] to boards[i] for i in 0..n-1; results as above.
+int ms_step_boards(ms_board *const *boards, const ms_move *moves, int32_t n,
+                   int8_t *results);
+
+// Writes one byte per cell, row-major. Returns the cell count, or MS_ERROR
+// if cap is too small.
+int ms_snapshot(const ms_board *board, uint8_t *out, size_t cap);
+
+// Once enabled, collects cells whose byte in ms_snapshot changed. Each call
+// writes up to cap of them and drops them from the log; returns how many
+// were written.
+int ms_track_changes(ms_board *board, int enable);
+int ms_take_changes(ms_board *board, int32_t *out, int32_t cap);
+
+#ifdef __cplusplus
+}
+#endif
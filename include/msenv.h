@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Batched environment over n same-size boards for training bots. Every
+// output buffer is owned by the caller and written in place, so it can be a
+// numpy array handed over by address; nothing is allocated after create.
+//
+// Observations are MSENV_PLANES uint8 planes of rows * cols cells per
+// board, boards back to back: obs[(b * MSENV_PLANES + p) * rows * cols + i].
+//   MSENV_PLANE_UNKNOWN  1 if the cell is hidden and not flagged
+//   MSENV_PLANE_FLAG     1 if the cell is flagged
+//   MSENV_PLANE_NUMBER   neighbouring mines for revealed cells, 0 otherwise
+//
+// Actions are one int32 per board: i in [0, cells) reveals cell i,
+// cells + i toggles the flag on cell i and a negative value does nothing.
+// Finished boards ignore actions until they are reset.
+
+#define MSENV_PLANES 3
+#define MSENV_PLANE_UNKNOWN 0
+#define MSENV_PLANE_FLAG 1
+#define MSENV_PLANE_NUMBER 2
+
+// Largest board, in cells, that msenv_create accepts; the same as
+// MS_MAX_CELLS in msapi.h.
+#define MSENV_MAX_CELLS (1 << 24)
+
+typedef struct MsEnv MsEnv;
+
+// Returns NULL if n or the board size is not positive, the board exceeds
+// MSENV_MAX_CELLS, or the boards cannot be allocated. No C++ exception
+// escapes any of these functions.
+MsEnv *msenv_create(int n, int rows, int cols, int mines);
+void msenv_destroy(MsEnv *env);
+
+int msenv_count(const MsEnv *env);
+// Bytes of obs per board.
+int msenv_obs_size(const MsEnv *env);
+
+// Starts boards 0..n-1 over with seeds[0..n-1]; the first reveal on each is
+// always safe. Returns 0, or -1 if env is NULL or n is negative or exceeds
+// the board count.
+int msenv_reset(MsEnv *env, const uint64_t *seeds, int n, uint8_t *obs);
+
+// Like msenv_reset but only for finished boards among 0..n-1; board b uses
+// seeds[b]. Returns how many boards were reset, or -1 if env is NULL or n
+// is negative.
+int msenv_reset_done(MsEnv *env, const uint64_t *seeds, int n, uint8_t *obs);
+
+// Applies actions[0..n-1] to boards 0..n-1. rewards[b] is the fraction of
+// the board's safe cells opened by the action, or -1 for hitting a mine;
+// dones[b] is 1 once the board is won or lost. Observations are rewritten
+// only for boards that took an action. Any output may be NULL.
+// Returns 0, or -1 if env is NULL or n is negative or exceeds the board
+// count.
+int msenv_step(MsEnv *env, const int32_t *actions, int n, uint8_t *obs,
+               float *rewards, uint8_t *dones);
+
+#ifdef __cplusplus
+}
+#endif
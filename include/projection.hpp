@@ -0,0 +1,24 @@
+#pragma once
+#include "../glad/glad.h"
+
+// Screen-space orthographic projection in a std140 uniform block named
+// Projection, shared by every program through one binding point. The
+// buffer is written only when the window size changes.
+class ProjectionBuffer {
+public:
+  static const GLuint kBinding = 0;
+
+  ~ProjectionBuffer();
+
+  void init();
+  void resize(int width, int height);
+
+  // Points prog's Projection block, if it has one, at kBinding; call once
+  // after linking.
+  static void attach(GLuint prog);
+
+private:
+  GLuint ubo = 0;
+  int width = 0;
+  int height = 0;
+};
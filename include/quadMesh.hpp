@@ -0,0 +1,26 @@
+#pragma once
+#include "../glad/glad.h"
+#include "atlas.hpp"
+#include <cstddef>
+#include <vector>
+
+// Textured quads kept in a static buffer and drawn from one texture with a
+// single call, for geometry that only changes when the window does.
+class QuadMesh {
+public:
+  ~QuadMesh();
+
+  void init();
+
+  void clear() { vertices.clear(); }
+  void add(float x, float y, float w, float h, const UVRect &uv);
+  // Replaces the buffer contents with the quads added since clear().
+  void upload();
+  void draw(GLuint prog, GLuint tex);
+
+private:
+  GLuint vao = 0, vbo = 0, ebo = 0;
+  size_t quadCount = 0;
+  size_t indexCapacity = 0;
+  std::vector<float> vertices;
+};
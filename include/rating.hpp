@@ -0,0 +1,38 @@
+#pragma once
+#include "board.hpp"
+#include <cstdint>
+
+// Weakest rule that makes progress, in increasing order of difficulty.
+enum class DeductionRule : uint8_t {
+  NONE = 0,
+  // A number already has all its mines flagged, or all its unknowns are
+  // mines.
+  SINGLE = 1,
+  // One number's unknowns are a subset of a neighbouring number's.
+  SUBSET = 2,
+  // Any consequence of the revealed numbers alone.
+  LOCAL = 3,
+  // Needs the global mine count as well.
+  GLOBAL = 4,
+};
+
+struct BoardRating {
+  uint64_t seed = 0;
+  int guesses = 0;
+  DeductionRule deepestRule = DeductionRule::NONE;
+  // Deduction steps that needed LOCAL or GLOBAL reasoning.
+  int hardSteps = 0;
+  // Chance of surviving every forced guess, taking the lowest-risk cell.
+  double survival = 1.0;
+  // Minimum number of clicks to clear the board without flags (3BV).
+  int bbbv = 0;
+  // deepestRule + 0.25 * hardSteps + 2 * guesses + 10 * (1 - survival).
+  float difficulty = 0.0f;
+};
+
+// Replays the board generated from seed, opening firstClick, using the
+// weakest deduction rule that makes progress at each step. When none does,
+// a guess is counted and the lowest-risk safe cell is opened so the replay
+// can continue.
+BoardRating rateBoard(int rows, int cols, int mines, uint64_t seed,
+                      int firstClick);
@@ -1,21 +1,21 @@
 #pragma once
 #include "../glad/glad.h"
+#include "atlas.hpp"
+#include "spriteBatch.hpp"
 
 class Renderer {
 public:
-  Renderer();
-  ~Renderer();
-
-  void init();
-
-  void setProjection(GLuint prog, int width, int height);
+  void init(bool persistentStream = true);
 
+  // Queued on the sprite batch; nothing is drawn until flush().
   void drawRect(GLuint prog, float x, float y, float w, float h,
                 unsigned int btnTex);
+  void drawRect(GLuint prog, float x, float y, float w, float h, GLuint tex,
+                const UVRect &uv);
+  void flush() { batch.flush(); }
+  void endFrame() { batch.endFrame(); }
+  double getStreamStall() const { return batch.getStreamStall(); }
 
 private:
-  GLuint VAO, VBO, EBO;
-
-  void updateQuad(float x, float y, float w, float h, float u0, float v0,
-                  float u1, float v1);
+  SpriteBatch batch;
 };
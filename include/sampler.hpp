@@ -0,0 +1,44 @@
+#pragma once
+#include "board.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+struct SampleOptions {
+  // Independent chains, one per thread; 0 uses every core (at least 2 so
+  // convergence can be judged).
+  int chains = 0;
+  uint64_t seed = 0x9E3779B97F4A7C15ull;
+  // Wall-clock budget; the sampler stops and reports whatever it has.
+  double deadlineMs = 50.0;
+  int burnInSweeps = 20;
+  // Metropolis temperature on violated constraints; lower keeps more sweeps
+  // valid, higher mixes faster between distant layouts.
+  double temperature = 0.5;
+  // Sampled layouts per chain that are played out with Bot to estimate the
+  // win probability. 0 skips playouts.
+  int playouts = 0;
+  double targetRHat = 1.05;
+};
+
+struct SampleResult {
+  std::vector<float> mineProbability;
+  // Fraction of played-out layouts the LOCAL bot won, -1 if none were played.
+  double winProbability = -1.0;
+  // Largest Gelman-Rubin statistic over the unknown cells.
+  double rHat = 0.0;
+  bool converged = false;
+  long samples = 0;
+  int chains = 0;
+};
+
+// Markov chain Monte Carlo over mine layouts consistent with every revealed
+// number and the global mine count, for positions too large to enumerate.
+class Sampler {
+public:
+  // Returns false if cancelled or if no consistent layout was found before
+  // the deadline.
+  static bool estimate(const BoardView &view, const SampleOptions &opts,
+                       SampleResult &out,
+                       const std::atomic<bool> *cancel = nullptr);
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Small CDCL SAT solver: two watched literals, first-UIP clause learning,
+// VSIDS decisions with phase saving and Luby restarts. Literals use DIMACS
+// numbering (+v / -v, variables from 1). Learned clauses are kept between
+// calls, so repeated solve() calls under different assumptions get cheaper.
+class SatSolver {
+public:
+  enum class Result { SAT, UNSAT, UNKNOWN };
+
+  int newVar();
+  int numVars() const { return (int)assigns.size(); }
+
+  // Only valid between solve() calls. Returns false once the clause set is
+  // known to be unsatisfiable.
+  bool addClause(const std::vector<int> &lits);
+
+  // conflictBudget < 0 means no limit; UNKNOWN is returned when the budget
+  // runs out or cancel is raised.
+  Result solve(const std::vector<int> &assumptions = {},
+               long conflictBudget = -1,
+               const std::atomic<bool> *cancel = nullptr);
+
+  // Value of var in the last SAT model.
+  bool modelValue(int var) const { return model[var - 1] == 1; }
+
+  long getConflicts() const { return conflicts; }
+  long getDecisions() const { return decisions; }
+  long getPropagations() const { return propagations; }
+
+private:
+  struct Clause {
+    std::vector<int> lits;
+    bool learnt;
+  };
+
+  static int toLit(int dimacs) {
+    return dimacs > 0 ? 2 * (dimacs - 1) : 2 * (-dimacs - 1) + 1;
+  }
+  // 1 true, 0 false, -1 unassigned.
+  int value(int lit) const {
+    int a = assigns[lit >> 1];
+    return a < 0 ? -1 : a ^ (lit & 1);
+  }
+  int decisionLevel() const { return (int)trailLim.size(); }
+
+  void enqueue(int lit, int reason);
+  int propagate();
+  void analyze(int conflict, std::vector<int> &learnt, int &backLevel);
+  void backtrack(int level);
+  int pickBranch();
+  void attach(int clause);
+
+  void bump(int var);
+  void heapInsert(int var);
+  void heapUp(int pos);
+  void heapDown(int pos);
+  int heapPop();
+
+  bool ok = true;
+  std::vector<Clause> clauses;
+  std::vector<std::vector<int>> watches;
+  std::vector<int8_t> assigns;
+  std::vector<int8_t> polarity;
+  std::vector<int8_t> model;
+  std::vector<int> level;
+  std::vector<int> reason;
+  std::vector<int> trail;
+  std::vector<int> trailLim;
+  size_t qhead = 0;
+
+  std::vector<double> activity;
+  double varInc = 1.0;
+  std::vector<int> heap;
+  std::vector<int> heapIndex;
+  std::vector<uint8_t> seen;
+
+  long conflicts = 0;
+  long decisions = 0;
+  long propagations = 0;
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include "board.hpp"
+#include <atomic>
+#include <vector>
+
+struct SatForced {
+  std::vector<int> safeCells;
+  std::vector<int> mineCells;
+  bool consistent = true;
+  // False if the conflict budget ran out before every query was decided.
+  bool complete = true;
+  long conflicts = 0;
+};
+
+// Decides forced cells by satisfiability instead of enumeration: the frontier
+// and the global mine count are encoded as CNF, and a cell is forced when the
+// opposite assignment is unsatisfiable. Cost grows with how hard the
+// constraints interlock rather than with the number of solutions, which is
+// what makes long endgame frontiers tractable.
+class SatBackend {
+public:
+  // query lists the cells to decide; empty means every frontier cell. Cells
+  // not adjacent to a revealed number are ignored. A negative view.mines
+  // leaves the global mine count out of the encoding.
+  static bool findForced(const BoardView &view, const std::vector<int> &query,
+                         SatForced &out, long conflictBudget = -1,
+                         const std::atomic<bool> *cancel = nullptr);
+};
@@ -4,7 +4,10 @@
 class Shader {
 public:
   static GLuint createProgram();
+  // Whole grid as one quad sampling a sprite array; see GridRenderer.
+  static GLuint createGridProgram();
 
 private:
   static GLuint compile(GLenum type, const char *src);
+  static GLuint link(const char *vertexSrc, const char *fragmentSrc);
 };
@@ -0,0 +1,117 @@
+#pragma once
+#include "board.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Board state and bot commands exchanged through a POSIX shared-memory
+// segment. The game publishes the board under a seqlock and bots read it
+// in place; bots push commands into a single-producer single-consumer ring
+// that the game drains. Neither side makes a syscall per move.
+
+enum SharedOp : uint32_t {
+  SHM_NEW = 1,
+  SHM_REVEAL = 2,
+  SHM_FLAG = 3,
+  SHM_CHORD = 4,
+  SHM_QUIT = 5,
+};
+
+struct SharedCommand {
+  uint32_t op;
+  uint32_t cell;
+  uint16_t rows, cols, mines, reserved;
+  uint64_t seed;
+};
+
+struct SharedSegment {
+  static const uint32_t kMagic = 0x4853534d; // "MSSH"
+  static const uint32_t kVersion = 2;
+  static const uint32_t kRingSize = 1024;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t maxCells;
+
+  // Odd while the game is writing the fields up to head, and the cells.
+  alignas(64) std::atomic<uint32_t> seq;
+  uint32_t rows, cols, mines, state;
+  uint64_t frame;
+  // Seconds on the game timer when this board was published.
+  double elapsed;
+
+  // The bot advances head after writing ring[head % kRingSize]; the game
+  // advances tail after reading.
+  alignas(64) std::atomic<uint32_t> head;
+  alignas(64) std::atomic<uint32_t> tail;
+  SharedCommand ring[kRingSize];
+
+  // One Board::code() byte per cell, row-major, maxCells bytes.
+  uint8_t *cells() { return reinterpret_cast<uint8_t *>(this + 1); }
+  const uint8_t *cells() const {
+    return reinterpret_cast<const uint8_t *>(this + 1);
+  }
+
+  static size_t bytesFor(int maxCells) {
+    return sizeof(SharedSegment) + (size_t)maxCells;
+  }
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "shared-memory atomics must be lock-free");
+
+struct SharedSnapshot {
+  int rows = 0;
+  int cols = 0;
+  int mines = 0;
+  GameState state = GameState::PLAYING;
+  uint64_t frame = 0;
+  double elapsed = 0.0;
+  std::vector<uint8_t> cells;
+};
+
+// Game side: owns the segment and unlinks it on close.
+class SharedBoardHost {
+public:
+  ~SharedBoardHost() { close(); }
+
+  bool open(const std::string &name, int maxCells);
+  void close();
+  bool isOpen() const { return seg != nullptr; }
+
+  void publish(const Board &board, double elapsed);
+  bool poll(SharedCommand &cmd);
+  // True if an SHM_NEW board of cmd.rows x cmd.cols fits the segment.
+  bool fits(const SharedCommand &cmd) const;
+
+private:
+  SharedSegment *seg = nullptr;
+  size_t bytes = 0;
+  std::string name;
+  uint64_t frame = 0;
+};
+
+// Bot side.
+class SharedBoardClient {
+public:
+  ~SharedBoardClient() { detach(); }
+
+  bool attach(const std::string &name);
+  void detach();
+
+  // Copies a consistent board into out; false if nothing is published yet.
+  bool read(SharedSnapshot &out) const;
+  // Changes on every publish, for polling without copying the board.
+  uint32_t sequence() const;
+  // False if the ring is full.
+  bool submit(const SharedCommand &cmd);
+
+private:
+  SharedSegment *seg = nullptr;
+  size_t bytes = 0;
+};
+
+// Headless game serving the segment until a SHM_QUIT command arrives.
+int serveShared(const std::string &name);
@@ -0,0 +1,69 @@
+#pragma once
+#include "board.hpp"
+#include "sampler.hpp"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+struct SolveResult {
+  uint64_t version = 0;
+  // Mine probability per cell, -1 for revealed or flagged cells.
+  std::vector<float> mineProbability;
+  std::vector<int> safeCells;
+  std::vector<int> mineCells;
+  int bestGuess = -1;
+  // Natural log of the number of mine layouts consistent with the view.
+  double logWeight = 0.0;
+  bool consistent = true;
+  int componentsSolved = 0;
+  int componentsReused = 0;
+  bool sampled = false;
+};
+
+class Solver {
+public:
+  // maxNodes bounds the backtracking done per frontier component; larger
+  // components fall back to a local density estimate.
+  explicit Solver(long maxNodes = 2000000);
+
+  // Returns false if cancelled before finishing; out is then unspecified.
+  // Components left unchanged since the previous call are reused from cache.
+  bool solve(const BoardView &view, SolveResult &out,
+             const std::atomic<bool> *cancel = nullptr);
+
+  void clearCache();
+
+  // Components the enumeration budget cannot cover are estimated with the
+  // MCMC sampler under these options; deadlineMs <= 0 disables sampling.
+  void setSampleOptions(const SampleOptions &opts);
+
+  // Forced cells in those components are then decided by the SAT backend,
+  // spending at most budget conflicts per query (< 0 unlimited, 0 off).
+  void setSatConflictBudget(long budget);
+
+private:
+  struct Component {
+    std::vector<int> cells;
+    std::vector<int> constraints;
+    bool exact = false;
+    // counts[k]: layouts of this component with k mines.
+    // cellCounts[i][k]: of those, layouts where cells[i] is a mine.
+    std::vector<double> counts;
+    std::vector<std::vector<double>> cellCounts;
+  };
+
+  struct Constraint {
+    std::vector<int> cells;
+    int need;
+  };
+
+  bool enumerate(Component &comp, const std::atomic<bool> *cancel);
+
+  long maxNodes;
+  SampleOptions sampling;
+  long satConflictBudget = 20000;
+  std::vector<Constraint> constraints;
+  std::vector<int> localIndex;
+  std::map<std::vector<int>, Component> cache;
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include "solver.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Runs the solver on a background thread. Submitting a new view cancels the
+// one in flight; finished results are swapped in atomically so the render
+// loop only ever reads a complete SolveResult.
+class SolverWorker {
+public:
+  explicit SolverWorker(long maxNodes = 2000000);
+  ~SolverWorker();
+
+  // Called on the worker thread after each result is published, e.g. to
+  // wake an idle event loop. Set before start().
+  void setOnPublish(std::function<void()> fn) { onPublish = std::move(fn); }
+
+  void start();
+  void stop();
+
+  void submit(const BoardView &view, uint64_t version);
+
+  std::shared_ptr<const SolveResult> latest() const;
+
+private:
+  void run();
+
+  Solver solver;
+  std::thread thread;
+  std::mutex mtx;
+  std::condition_variable cv;
+  BoardView pending;
+  uint64_t pendingVersion = 0;
+  bool hasPending = false;
+  bool stopping = false;
+  std::atomic<bool> cancel;
+  std::shared_ptr<const SolveResult> published;
+  std::function<void()> onPublish;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include "../glad/glad.h"
+#include "streamBuffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Collects textured quads into one streaming vertex buffer and draws them,
+// grouped by texture, in as few calls as there are distinct textures. Quads
+// sharing a texture keep their submission order, but quads with different
+// textures may be reordered, so overlapping layers need a flush() between
+// them.
+class SpriteBatch {
+public:
+  ~SpriteBatch();
+
+  void init(bool persistentStream = true);
+
+  // Queues a quad for prog; switching program flushes what is queued.
+  void add(GLuint prog, float x, float y, float w, float h, GLuint tex,
+           float u0 = 0.0f, float v0 = 0.0f, float u1 = 1.0f,
+           float v1 = 1.0f);
+  void flush();
+  // Call once per frame after the last flush.
+  void endFrame() { stream.endFrame(); }
+  double getStreamStall() const { return stream.getLastStall(); }
+
+private:
+  struct Quad {
+    GLuint tex;
+    float x, y, w, h, u0, v0, u1, v1;
+  };
+
+  void reserve(size_t quadCount);
+
+  GLuint vao = 0, ebo = 0;
+  StreamBuffer stream;
+  GLuint program = 0;
+  size_t capacity = 0;
+  std::vector<Quad> quads;
+  std::vector<float> vertices;
+};
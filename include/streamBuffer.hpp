@@ -0,0 +1,47 @@
+#pragma once
+#include "../glad/glad.h"
+#include <cstddef>
+
+// Ring of vertex data written by the CPU every frame. With buffer storage
+// (GL 4.4) the buffer is mapped once, persistent and coherent, and split
+// into kRegions regions; a fence per region keeps the CPU from writing
+// one the GPU may still read. Without it, each frame orphans the buffer
+// and appends through unsynchronized maps.
+class StreamBuffer {
+public:
+  static const int kRegions = 3;
+
+  ~StreamBuffer();
+
+  // regionBytes is the space per frame; it grows if a frame needs more.
+  void init(size_t regionBytes, bool allowPersistent = true);
+
+  // Copies data in at a multiple of align and returns its offset. The
+  // buffer is left bound to GL_ARRAY_BUFFER; attribute pointers must be
+  // set from the offset since the buffer and offset change between writes.
+  size_t write(const void *data, size_t bytes, size_t align);
+  // Fences this frame's region and moves to the next.
+  void endFrame();
+
+  GLuint getBuffer() const { return buffer; }
+  bool isPersistent() const { return persistent; }
+  // Seconds spent waiting on fences or inside map calls during the last
+  // completed frame.
+  double getLastStall() const { return lastStall; }
+
+private:
+  void allocate(size_t regionBytes);
+  void release();
+  void waitRegion(int region);
+
+  GLuint buffer = 0;
+  bool persistent = false;
+  unsigned char *mapped = nullptr;
+  size_t regionSize = 0;
+  size_t cursor = 0;
+  int region = 0;
+  bool regionReady = false;
+  GLsync fences[kRegions] = {};
+  double stall = 0.0;
+  double lastStall = 0.0;
+};
@@ -1,18 +1,25 @@
 #pragma once
 #include "../ext/stb_truetype.h"
 #include "../glad/glad.h"
+#include "streamBuffer.hpp"
 #include <string>
 
 class TextRenderer {
 public:
-  void init(const char *filename, float pixelHeight);
+  void init(const char *filename, float pixelHeight,
+            bool persistentStream = true);
   float getWidth(const std::string &text, float scale);
+  // Positions are in window pixels, as set by the shared projection block.
   void drawText(const std::string &text, float x, float y, float scale, float r,
-                float g, float b, float sW, float sH);
+                float g, float b);
+  // Call once per frame after the last drawText.
+  void endFrame() { stream.endFrame(); }
+  double getStreamStall() const { return stream.getLastStall(); }
 
 private:
   GLuint texID;
   stbtt_bakedchar cdata[96];
-  GLuint vao, vbo;
+  GLuint vao;
+  StreamBuffer stream;
   GLuint shaderProgram;
 };
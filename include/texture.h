@@ -1,9 +1,19 @@
 #pragma once
 #include "../glad/glad.h"
 #include <string>
+#include <vector>
 
 GLuint loadTexture(const std::string &path, int svgW = 0, int svgH = 0);
 
 inline GLuint loadTexture(const char *path, int svgW = 0, int svgH = 0) {
   return loadTexture(std::string(path), svgW, svgH);
 }
+
+// Decodes an image to RGBA, box-filtered (raster) or rendered (SVG) to w x h;
+// a raster image keeps its own size when w or h is 0.
+bool loadImage(const std::string &path, int w, int h,
+               std::vector<unsigned char> &rgba, int &outW, int &outH);
+
+// Loads each image into one layer of a GL_TEXTURE_2D_ARRAY, box-filtered to
+// size x size RGBA. Images that fail to load leave their layer transparent.
+GLuint loadTextureArray(const std::vector<std::string> &paths, int size);
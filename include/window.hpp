@@ -9,7 +9,12 @@ public:
   ~Window();
 
   bool init();
-  void update();
+  void present();
+  // Blocks until an event arrives or timeout seconds pass; a negative
+  // timeout waits for an event.
+  void waitEvents(double timeout);
+  // True once after the system asks for the contents to be redrawn.
+  bool takeRefreshRequest();
   void close();
 
   bool shouldClose() const;
@@ -31,4 +36,5 @@ private:
   int height;
   std::string title;
   bool resizable;
+  bool refreshRequested = true;
 };
@@ -0,0 +1,102 @@
+#include "../include/atlas.hpp"
+#include "../include/glState.hpp"
+#include "../include/texture.h"
+#include <algorithm>
+
+static int roundUp(int v, int to) { return (v + to - 1) / to * to; }
+
+int TextureAtlas::add(const std::string &path, int w, int h) {
+  Entry e;
+  if (!loadImage(path, w, h, e.pixels, e.w, e.h)) {
+    e.w = e.h = 0;
+    e.uv = UVRect{0.0f, 0.0f, 0.0f, 0.0f};
+  }
+  entries.push_back(std::move(e));
+  return (int)entries.size() - 1;
+}
+
+// Shelf packing, tallest first. The width is the smallest power of two
+// that fits the widest image and roughly a square of the total area.
+void TextureAtlas::pack() {
+  std::vector<int> order;
+  long area = 0;
+  int widest = 0;
+  for (int i = 0; i < (int)entries.size(); ++i) {
+    const Entry &e = entries[i];
+    if (e.w == 0)
+      continue;
+    int pw = roundUp(e.w + 2 * kGutter, kAlign);
+    int ph = roundUp(e.h + 2 * kGutter, kAlign);
+    area += (long)pw * ph;
+    widest = std::max(widest, pw);
+    order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return entries[a].h > entries[b].h;
+  });
+
+  width = 1;
+  while (width < widest || (long)width * width < area)
+    width *= 2;
+
+  int x = 0, y = 0, shelf = 0;
+  for (int i : order) {
+    Entry &e = entries[i];
+    int pw = roundUp(e.w + 2 * kGutter, kAlign);
+    int ph = roundUp(e.h + 2 * kGutter, kAlign);
+    if (x + pw > width) {
+      y += shelf;
+      x = 0;
+      shelf = 0;
+    }
+    e.x = x + kGutter;
+    e.y = y + kGutter;
+    x += pw;
+    shelf = std::max(shelf, ph);
+  }
+  height = std::max(kAlign, roundUp(y + shelf, kAlign));
+}
+
+GLuint TextureAtlas::build() {
+  pack();
+  if (width <= 1)
+    return 0;
+
+  std::vector<unsigned char> pixels((size_t)width * height * 4, 0);
+  for (Entry &e : entries) {
+    if (e.w == 0)
+      continue;
+    // Copy the image with its border texels repeated into the gutter.
+    for (int dy = -kGutter; dy < e.h + kGutter; ++dy) {
+      int sy = std::min(std::max(dy, 0), e.h - 1);
+      for (int dx = -kGutter; dx < e.w + kGutter; ++dx) {
+        int sx = std::min(std::max(dx, 0), e.w - 1);
+        const unsigned char *src = &e.pixels[(sy * e.w + sx) * 4];
+        unsigned char *dst =
+            &pixels[((size_t)(e.y + dy) * width + (e.x + dx)) * 4];
+        std::copy(src, src + 4, dst);
+      }
+    }
+    e.uv = UVRect{(float)e.x / width, (float)e.y / height,
+                  (float)(e.x + e.w) / width, (float)(e.y + e.h) / height};
+    e.pixels.clear();
+    e.pixels.shrink_to_fit();
+  }
+
+  GLuint tex = 0;
+  glGenTextures(1, &tex);
+  glState.bindTexture(GL_TEXTURE_2D, tex);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, kMaxLevel);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                  GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  // Not glTexStorage2D, which is GL 4.2; MAX_LEVEL stops the mip chain at
+  // kMaxLevel instead.
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
+               GL_UNSIGNED_BYTE, pixels.data());
+  glGenerateMipmap(GL_TEXTURE_2D);
+  return tex;
+}
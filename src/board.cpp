@@ -0,0 +1,210 @@
+#include "../include/board.hpp"
+#include <random>
+
+static const int kDir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+                               {0, 1},   {1, -1}, {1, 0},  {1, 1}};
+
+const DifficultyLevel &difficultyLevel(Difficulty d) {
+  static const DifficultyLevel levels[] = {
+      {"beginner", 9, 9}, {"intermediate", 16, 16}, {"expert", 30, 30}};
+  return levels[(int)d];
+}
+
+int Board::defaultMineCount(int rows, int cols) {
+  int totalCells = rows * cols;
+  if (totalCells == 81)
+    return 10;
+  if (totalCells == 256)
+    return 40;
+  if (totalCells == 480)
+    return 99;
+  return (int)(totalCells * 0.15);
+}
+
+void Board::reset(int r, int c, int m, uint64_t s) {
+  rows = r;
+  cols = c;
+  mines = m;
+  seed = s;
+  flagged = 0;
+  revealedCount = 0;
+  generated = false;
+  state = GameState::PLAYING;
+  cells.assign(rows * cols, Cell{false, false, false, 0});
+  stack.reserve(cells.size());
+  changes.clear();
+}
+
+void Board::generate(int safeIndex) {
+  int maxIndex = rows * cols;
+  if (mines > maxIndex - 9)
+    mines = maxIndex - 9;
+  if (mines < 0)
+    mines = 0;
+
+  int safeR = safeIndex / cols;
+  int safeC = safeIndex % cols;
+  std::vector<int> candidates;
+  candidates.reserve(maxIndex);
+  for (int i = 0; i < maxIndex; ++i) {
+    int dr = i / cols - safeR;
+    int dc = i % cols - safeC;
+    if (dr >= -1 && dr <= 1 && dc >= -1 && dc <= 1)
+      continue;
+    candidates.push_back(i);
+  }
+  if (mines > (int)candidates.size())
+    mines = (int)candidates.size();
+
+  std::mt19937_64 rng(seed);
+  for (int i = 0; i < mines; ++i) {
+    int j = i + (int)(rng() % (uint64_t)(candidates.size() - i));
+    std::swap(candidates[i], candidates[j]);
+    cells[candidates[i]].mine = true;
+  }
+  computeAdjacency();
+  generated = true;
+}
+
+void Board::placeMines(const std::vector<int> &mineIndices) {
+  for (auto &c : cells)
+    c.mine = false;
+  for (int idx : mineIndices)
+    cells[idx].mine = true;
+  mines = (int)mineIndices.size();
+  computeAdjacency();
+  generated = true;
+}
+
+void Board::computeAdjacency() {
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      int count = 0;
+      for (auto &d : kDir) {
+        int nr = r + d[0];
+        int nc = c + d[1];
+        if (nr >= 0 && nr < rows && nc >= 0 && nc < cols &&
+            cells[nr * cols + nc].mine)
+          count++;
+      }
+      cells[r * cols + c].adjacent = (uint8_t)count;
+    }
+  }
+}
+
+RevealResult Board::reveal(int index) {
+  if (state != GameState::PLAYING)
+    return RevealResult::CONTINUE;
+  Cell &first = cells[index];
+  if (first.flagged || first.revealed)
+    return RevealResult::CONTINUE;
+
+  if (!generated)
+    generate(index);
+
+  if (first.mine) {
+    first.revealed = true;
+    if (trackChanges)
+      changes.push_back(index);
+    state = GameState::LOST;
+    return RevealResult::GAME_OVER;
+  }
+
+  stack.clear();
+  stack.push_back(index);
+  first.revealed = true;
+  while (!stack.empty()) {
+    int cur = stack.back();
+    stack.pop_back();
+    revealedCount++;
+    if (trackChanges)
+      changes.push_back(cur);
+    if (cells[cur].adjacent != 0)
+      continue;
+
+    int r = cur / cols;
+    int c = cur % cols;
+    for (auto &d : kDir) {
+      int nr = r + d[0];
+      int nc = c + d[1];
+      if (nr < 0 || nr >= rows || nc < 0 || nc >= cols)
+        continue;
+      Cell &n = cells[nr * cols + nc];
+      if (!n.revealed && !n.flagged && !n.mine) {
+        n.revealed = true;
+        stack.push_back(nr * cols + nc);
+      }
+    }
+  }
+
+  if (revealedCount == (int)cells.size() - mines) {
+    state = GameState::WON;
+    return RevealResult::WIN;
+  }
+  return RevealResult::CONTINUE;
+}
+
+bool Board::toggleFlag(int index) {
+  Cell &c = cells[index];
+  if (state != GameState::PLAYING || c.revealed)
+    return false;
+  c.flagged = !c.flagged;
+  flagged += c.flagged ? 1 : -1;
+  if (trackChanges)
+    changes.push_back(index);
+  return true;
+}
+
+RevealResult Board::chord(int index) {
+  const Cell &c = cells[index];
+  if (state != GameState::PLAYING || !c.revealed || c.adjacent == 0)
+    return RevealResult::CONTINUE;
+
+  int r = index / cols;
+  int col = index % cols;
+  int flags = 0;
+  for (auto &d : kDir) {
+    int nr = r + d[0];
+    int nc = col + d[1];
+    if (nr >= 0 && nr < rows && nc >= 0 && nc < cols &&
+        cells[nr * cols + nc].flagged)
+      flags++;
+  }
+  if (flags != c.adjacent)
+    return RevealResult::CONTINUE;
+
+  RevealResult result = RevealResult::CONTINUE;
+  for (auto &d : kDir) {
+    int nr = r + d[0];
+    int nc = col + d[1];
+    if (nr < 0 || nr >= rows || nc < 0 || nc >= cols)
+      continue;
+    RevealResult res = reveal(nr * cols + nc);
+    if (res != RevealResult::CONTINUE)
+      result = res;
+  }
+  return result;
+}
+
+uint8_t Board::code(int index) const {
+  const Cell &c = cells[index];
+  if (c.revealed)
+    return c.mine ? (uint8_t)CODE_MINE : c.adjacent;
+  return c.flagged ? (uint8_t)CODE_FLAGGED : (uint8_t)CODE_HIDDEN;
+}
+
+BoardView BoardView::of(const Board &board) {
+  BoardView v;
+  v.rows = board.getRows();
+  v.cols = board.getCols();
+  v.mines = board.getMineCount();
+  v.cells.resize(board.size());
+  for (int i = 0; i < board.size(); ++i) {
+    const Cell &c = board.at(i);
+    if (c.revealed)
+      v.cells[i] = c.mine ? (int8_t)CELL_FLAGGED : (int8_t)c.adjacent;
+    else
+      v.cells[i] = c.flagged ? CELL_FLAGGED : CELL_UNKNOWN;
+  }
+  return v;
+}
@@ -0,0 +1,176 @@
+#include "../include/bot.hpp"
+
+static const int kDir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+                               {0, 1},   {1, -1}, {1, 0},  {1, 1}};
+
+Bot::Bot(Policy policy) : policy(policy), solver(200000) {
+  SampleOptions noSampling;
+  noSampling.deadlineMs = 0.0;
+  solver.setSampleOptions(noSampling);
+  if (policy == Policy::EXPECTIMAX) {
+    GuessOptions opts;
+    opts.threads = 1;
+    guesser.reset(new GuessEngine(opts));
+  }
+}
+
+bool Bot::nextMoves(const Board &board, std::mt19937_64 &rng,
+                    std::vector<Move> &out) {
+  if (board.getState() != GameState::PLAYING)
+    return false;
+
+  int rows = board.getRows();
+  int cols = board.getCols();
+  if (!board.isGenerated()) {
+    if (policy != Policy::LOCAL)
+      solver.clearCache();
+    if (guesser)
+      guesser->clearCache();
+    out.push_back({(int)(rng() % (uint64_t)board.size()), false});
+    return true;
+  }
+
+  size_t before = out.size();
+  for (int i = 0; i < board.size(); ++i) {
+    const Cell &c = board.at(i);
+    if (!c.revealed)
+      continue;
+    int r = i / cols, col = i % cols;
+    int unknown = 0, flags = 0;
+    for (auto &d : kDir) {
+      int nr = r + d[0], nc = col + d[1];
+      if (nr < 0 || nr >= rows || nc < 0 || nc >= cols)
+        continue;
+      const Cell &n = board.at(nr * cols + nc);
+      if (n.flagged)
+        flags++;
+      else if (!n.revealed)
+        unknown++;
+    }
+    if (unknown == 0)
+      continue;
+    bool allSafe = c.adjacent == flags;
+    bool allMines = c.adjacent - flags == unknown;
+    if (!allSafe && !allMines)
+      continue;
+    for (auto &d : kDir) {
+      int nr = r + d[0], nc = col + d[1];
+      if (nr < 0 || nr >= rows || nc < 0 || nc >= cols)
+        continue;
+      int ni = nr * cols + nc;
+      const Cell &n = board.at(ni);
+      if (!n.flagged && !n.revealed)
+        out.push_back({ni, allMines});
+    }
+  }
+  if (out.size() > before)
+    return true;
+
+  if (policy != Policy::LOCAL) {
+    BoardView view = BoardView::of(board);
+    solver.solve(view, solved);
+    for (int i : solved.safeCells)
+      out.push_back({i, false});
+    for (int i : solved.mineCells)
+      out.push_back({i, true});
+    if (out.size() > before)
+      return true;
+    if (guesser && solved.consistent) {
+      int guess = guesser->choose(view);
+      if (guess >= 0) {
+        out.push_back({guess, false});
+        return true;
+      }
+    }
+    if (solved.consistent && solved.bestGuess >= 0) {
+      out.push_back({solved.bestGuess, false});
+      return true;
+    }
+  }
+
+  int guess = guessLocal(board, rng);
+  if (guess < 0)
+    return false;
+  out.push_back({guess, false});
+  return true;
+}
+
+int Bot::guessLocal(const Board &board, std::mt19937_64 &rng) {
+  int rows = board.getRows();
+  int cols = board.getCols();
+  int unknown = 0;
+  for (int i = 0; i < board.size(); ++i)
+    if (!board.at(i).revealed && !board.at(i).flagged)
+      unknown++;
+  if (unknown == 0)
+    return -1;
+  float density =
+      (float)(board.getMineCount() - board.getFlaggedCount()) / unknown;
+
+  risk.assign(board.size(), -1.0f);
+  for (int i = 0; i < board.size(); ++i) {
+    const Cell &c = board.at(i);
+    if (!c.revealed)
+      continue;
+    int r = i / cols, col = i % cols;
+    int open = 0, flags = 0;
+    for (auto &d : kDir) {
+      int nr = r + d[0], nc = col + d[1];
+      if (nr < 0 || nr >= rows || nc < 0 || nc >= cols)
+        continue;
+      const Cell &n = board.at(nr * cols + nc);
+      if (n.flagged)
+        flags++;
+      else if (!n.revealed)
+        open++;
+    }
+    if (open == 0)
+      continue;
+    float p = (float)(c.adjacent - flags) / open;
+    for (auto &d : kDir) {
+      int nr = r + d[0], nc = col + d[1];
+      if (nr < 0 || nr >= rows || nc < 0 || nc >= cols)
+        continue;
+      int ni = nr * cols + nc;
+      if (p > risk[ni])
+        risk[ni] = p;
+    }
+  }
+
+  int best = -1;
+  float bestRisk = 2.0f;
+  int ties = 0;
+  for (int i = 0; i < board.size(); ++i) {
+    const Cell &c = board.at(i);
+    if (c.revealed || c.flagged)
+      continue;
+    float p = risk[i] < 0.0f ? density : risk[i];
+    if (p < bestRisk) {
+      best = i;
+      bestRisk = p;
+      ties = 1;
+    } else if (p == bestRisk && rng() % (uint64_t)++ties == 0) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+bool Bot::play(Board &board, std::mt19937_64 &rng) {
+  while (board.getState() == GameState::PLAYING) {
+    moves.clear();
+    if (!nextMoves(board, rng, moves))
+      break;
+    for (const Move &m : moves) {
+      if (m.flag) {
+        if (!board.at(m.index).flagged)
+          board.toggleFlag(m.index);
+      } else {
+        board.reveal(m.index);
+      }
+      if (board.getState() != GameState::PLAYING)
+        break;
+    }
+  }
+  return board.getState() == GameState::WON;
+}
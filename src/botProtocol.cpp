@@ -0,0 +1,282 @@
+#include "../include/botProtocol.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+static const uint32_t kMaxPayload = 1u << 26;
+static const int kMaxCells = 1 << 24;
+
+static const char *stateName(GameState s) {
+  return s == GameState::WON ? "won" : s == GameState::LOST ? "lost"
+                                                            : "playing";
+}
+
+static char valueChar(uint8_t v) {
+  return v < CODE_HIDDEN ? (char)('0' + v)
+         : v == CODE_HIDDEN  ? '.'
+         : v == CODE_FLAGGED ? 'F'
+                             : '*';
+}
+
+static void putU16(std::vector<uint8_t> &b, uint16_t v) {
+  b.push_back((uint8_t)v);
+  b.push_back((uint8_t)(v >> 8));
+}
+
+static void putU32(std::vector<uint8_t> &b, uint32_t v) {
+  for (int i = 0; i < 4; ++i)
+    b.push_back((uint8_t)(v >> (8 * i)));
+}
+
+static uint64_t getLE(const uint8_t *p, int n) {
+  uint64_t v = 0;
+  for (int i = n - 1; i >= 0; --i)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+static bool readLine(FILE *in, std::string &line) {
+  line.clear();
+  char buf[4096];
+  while (std::fgets(buf, sizeof(buf), in)) {
+    line += buf;
+    if (!line.empty() && line.back() == '\n') {
+      line.pop_back();
+      return true;
+    }
+  }
+  return !line.empty();
+}
+
+int BotProtocol::run(FILE *in, FILE *out) {
+  std::string error;
+  bool dumped = false;
+  if (mode == Mode::TEXT) {
+    std::string line;
+    while (readLine(in, line)) {
+      int failed = -1;
+      if (!parseText(line, cmds, error))
+        failed = (int)cmds.size();
+      int execFailed = execute(cmds, dumped);
+      if (execFailed >= 0) {
+        failed = execFailed;
+        error = "bad command";
+      }
+      replyText(out, failed, error, dumped);
+    }
+    return 0;
+  }
+
+  std::vector<uint8_t> payload;
+  uint8_t header[4];
+  while (std::fread(header, 1, 4, in) == 4) {
+    uint32_t len = (uint32_t)getLE(header, 4);
+    if (len > kMaxPayload)
+      return 1;
+    payload.resize(len);
+    if (std::fread(payload.data(), 1, len, in) != len)
+      return 1;
+    int failed = -1;
+    if (!parseBinary(payload, cmds))
+      failed = (int)cmds.size();
+    int execFailed = execute(cmds, dumped);
+    if (execFailed >= 0)
+      failed = execFailed;
+    replyBinary(out, failed, dumped);
+  }
+  return 0;
+}
+
+// On a parse error cmds holds the commands before the bad one, which still
+// run.
+bool BotProtocol::parseText(const std::string &line,
+                            std::vector<Command> &out, std::string &error) {
+  out.clear();
+  const char *p = line.c_str();
+  for (;;) {
+    while (*p == ' ' || *p == ';' || *p == '\t' || *p == '\r')
+      p++;
+    if (*p == '\0')
+      return true;
+    char op = *p++;
+    Command cmd{};
+    char *end = nullptr;
+    switch (op) {
+    case 'n': {
+      long v[3];
+      for (long &x : v) {
+        x = std::strtol(p, &end, 10);
+        if (end == p) {
+          error = "usage: n ROWS COLS MINES SEED";
+          return false;
+        }
+        p = end;
+      }
+      cmd.seed = std::strtoull(p, &end, 10);
+      if (end == p) {
+        error = "usage: n ROWS COLS MINES SEED";
+        return false;
+      }
+      p = end;
+      cmd.op = NEW;
+      cmd.rows = (int)v[0];
+      cmd.cols = (int)v[1];
+      cmd.mines = (int)v[2];
+      break;
+    }
+    case 'r':
+    case 'f':
+    case 'c':
+      cmd.cell = (int)std::strtol(p, &end, 10);
+      if (end == p) {
+        error = "missing cell";
+        return false;
+      }
+      p = end;
+      cmd.op = op == 'r' ? REVEAL : op == 'f' ? FLAG : CHORD;
+      break;
+    case 'd':
+      cmd.op = DUMP;
+      break;
+    default:
+      error = std::string("unknown command ") + op;
+      return false;
+    }
+    out.push_back(cmd);
+  }
+}
+
+bool BotProtocol::parseBinary(const std::vector<uint8_t> &payload,
+                              std::vector<Command> &out) {
+  out.clear();
+  const uint8_t *p = payload.data();
+  const uint8_t *end = p + payload.size();
+  while (p < end) {
+    Command cmd{};
+    cmd.op = (Op)*p++;
+    switch (cmd.op) {
+    case NEW:
+      if (end - p < 14)
+        return false;
+      cmd.rows = (int)getLE(p, 2);
+      cmd.cols = (int)getLE(p + 2, 2);
+      cmd.mines = (int)getLE(p + 4, 2);
+      cmd.seed = getLE(p + 6, 8);
+      p += 14;
+      break;
+    case REVEAL:
+    case FLAG:
+    case CHORD:
+      if (end - p < 4)
+        return false;
+      cmd.cell = (int)(uint32_t)getLE(p, 4);
+      p += 4;
+      break;
+    case DUMP:
+      break;
+    default:
+      return false;
+    }
+    out.push_back(cmd);
+  }
+  return true;
+}
+
+int BotProtocol::execute(const std::vector<Command> &list, bool &dumped) {
+  dumped = false;
+  for (size_t k = 0; k < list.size(); ++k) {
+    const Command &cmd = list[k];
+    if (cmd.op == NEW) {
+      if (cmd.rows <= 0 || cmd.cols <= 0 ||
+          (long)cmd.rows * cmd.cols > kMaxCells)
+        return (int)k;
+      board.reset(cmd.rows, cmd.cols, cmd.mines, cmd.seed);
+      board.setTrackChanges(true);
+      marked.assign(board.size(), 0);
+      changed.clear();
+      started = true;
+      continue;
+    }
+    if (!started)
+      return (int)k;
+    if (cmd.op == DUMP) {
+      dumped = true;
+      continue;
+    }
+    if (cmd.cell < 0 || cmd.cell >= board.size())
+      return (int)k;
+    if (cmd.op == REVEAL)
+      board.reveal(cmd.cell);
+    else if (cmd.op == FLAG)
+      board.toggleFlag(cmd.cell);
+    else
+      board.chord(cmd.cell);
+    collectChanges();
+  }
+  return -1;
+}
+
+void BotProtocol::collectChanges() {
+  for (int i : board.getChanges()) {
+    if (!marked[i]) {
+      marked[i] = 1;
+      changed.push_back(i);
+    }
+  }
+  board.clearChanges();
+}
+
+void BotProtocol::replyText(FILE *out, int failed, const std::string &error,
+                            bool dumped) {
+  text.clear();
+  text += failed >= 0 ? "err " : "ok ";
+  text += started ? stateName(board.getState()) : "none";
+  text += ' ';
+  text += std::to_string(changed.size());
+  for (int i : changed) {
+    text += ' ';
+    text += std::to_string(i);
+    text += ':';
+    text += valueChar(board.code(i));
+    marked[i] = 0;
+  }
+  changed.clear();
+  if (dumped) {
+    text += " board " + std::to_string(board.getRows()) + ' ' +
+            std::to_string(board.getCols()) + ' ' +
+            std::to_string(board.getMineCount()) + ' ';
+    for (int i = 0; i < board.size(); ++i)
+      text += valueChar(board.code(i));
+  }
+  if (failed >= 0)
+    text += " # " + std::to_string(failed + 1) + ": " + error;
+  text += '\n';
+  std::fwrite(text.data(), 1, text.size(), out);
+  std::fflush(out);
+}
+
+void BotProtocol::replyBinary(FILE *out, int failed, bool dumped) {
+  bytes.assign(4, 0);
+  bytes.push_back(failed >= 0 ? (uint8_t)std::min(failed + 1, 255) : 0);
+  bytes.push_back((uint8_t)(started ? (int)board.getState() : 0));
+  putU32(bytes, (uint32_t)changed.size());
+  for (int i : changed) {
+    putU32(bytes, (uint32_t)i);
+    bytes.push_back(board.code(i));
+    marked[i] = 0;
+  }
+  changed.clear();
+  bytes.push_back(dumped ? 1 : 0);
+  if (dumped) {
+    putU16(bytes, (uint16_t)board.getRows());
+    putU16(bytes, (uint16_t)board.getCols());
+    putU16(bytes, (uint16_t)board.getMineCount());
+    for (int i = 0; i < board.size(); ++i)
+      bytes.push_back(board.code(i));
+  }
+  uint32_t len = (uint32_t)(bytes.size() - 4);
+  for (int i = 0; i < 4; ++i)
+    bytes[i] = (uint8_t)(len >> (8 * i));
+  std::fwrite(bytes.data(), 1, bytes.size(), out);
+  std::fflush(out);
+}
@@ -2,75 +2,84 @@
 #include "../include/config.hpp"
 #include "../include/shader.hpp"
 #include "../include/texture.h"
-#include <cstdlib>
-#include <ctime>
-#include <queue>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <tuple>
 
-static inline int rcToIndex(int r, int c, int cols) { return r * cols + c; }
+MinesweeperGame::MinesweeperGame(GameClock *clock)
+    : clock(clock ? clock : &monotonicClock),
+      solverWorker(cfg.hints.maxSolverNodes) {}
 
-MinesweeperGame::MinesweeperGame() {}
-
-MinesweeperGame::~MinesweeperGame() { glDeleteProgram(shaderProgram); }
+MinesweeperGame::~MinesweeperGame() { glState.deleteProgram(shaderProgram); }
 
 void MinesweeperGame::init() {
-  renderer.init();
+  projection.init();
+  renderer.init(cfg.render.persistentBuffers);
+  gridRenderer.init();
+  chrome.init();
   shaderProgram = Shader::createProgram();
-  textRenderer.init(cfg.paths.font.c_str(), cfg.ui.fontSize);
-
-  assets.closed = loadTexture(cfg.paths.closedTile.c_str(), 40, 40);
-  assets.hover = loadTexture(cfg.paths.hoverTile.c_str(), 40, 40);
-  assets.mine = loadTexture(cfg.paths.mine.c_str(), 40, 40);
-  assets.mineRed = loadTexture(cfg.paths.mineRed.c_str(), 40, 40);
-  assets.flag = loadTexture(cfg.paths.flag.c_str(), 40, 40);
-  assets.wrongFlag = loadTexture(cfg.paths.wrongFlag.c_str(), 40, 40);
-
-  for (int i = 0; i <= 8; ++i)
-    assets.numbers.push_back(
-        loadTexture(cfg.paths.getNumberPath(i).c_str(), 40, 40));
-
-  assets.yellowNumbers.push_back(assets.numbers[0]);
-  for (int i = 1; i <= 8; ++i)
-    assets.yellowNumbers.push_back(
-        loadTexture(cfg.paths.getYellowNumberPath(i).c_str(), 40, 40));
+  textRenderer.init(cfg.paths.font.c_str(), cfg.ui.fontSize,
+                    cfg.render.persistentBuffers);
+  heatmap.init();
+
+  std::vector<std::string> sprites(SPRITE_COUNT);
+  sprites[SPRITE_CLOSED] = cfg.paths.closedTile;
+  sprites[SPRITE_HOVER] = cfg.paths.hoverTile;
+  sprites[SPRITE_MINE] = cfg.paths.mine;
+  sprites[SPRITE_MINE_RED] = cfg.paths.mineRed;
+  sprites[SPRITE_FLAG] = cfg.paths.flag;
+  sprites[SPRITE_WRONG_FLAG] = cfg.paths.wrongFlag;
+  for (int i = 0; i <= 8; ++i) {
+    sprites[SPRITE_NUMBER + i] = cfg.paths.getNumberPath(i);
+    sprites[SPRITE_YELLOW + i] =
+        i == 0 ? cfg.paths.getNumberPath(0) : cfg.paths.getYellowNumberPath(i);
+  }
+  assets.tileSprites = loadTextureArray(sprites, cfg.render.tileSpriteSize);
 
+  // Digits and faces are drawn at up to about twice their base UI size;
+  // border pieces keep their own size.
+  TextureAtlas atlas;
+  int digits[10];
   for (int i = 0; i <= 9; ++i)
-    assets.digits.push_back(
-        loadTexture(cfg.paths.getDigitPath(i).c_str(), 26, 46));
+    digits[i] = atlas.add(cfg.paths.getDigitPath(i), 42, 80);
+  int faceHappy = atlas.add(cfg.paths.faceHappy, 84, 84);
+  int faceO = atlas.add(cfg.paths.faceO, 84, 84);
+  int faceDead = atlas.add(cfg.paths.faceDead, 84, 84);
+  int borderH = atlas.add(cfg.paths.borderH);
+  int borderV = atlas.add(cfg.paths.borderV);
+  int cornerTL = atlas.add(cfg.paths.cornerTL);
+  int cornerTR = atlas.add(cfg.paths.cornerTR);
+  int cornerBL = atlas.add(cfg.paths.cornerBL);
+  int cornerBR = atlas.add(cfg.paths.cornerBR);
+  assets.atlas = atlas.build();
 
-  assets.faceHappy = loadTexture(cfg.paths.faceHappy.c_str(), 50, 50);
-  assets.faceO = loadTexture(cfg.paths.faceO.c_str(), 50, 50);
-  assets.faceDead = loadTexture(cfg.paths.faceDead.c_str(), 50, 50);
+  for (int i = 0; i <= 9; ++i)
+    assets.digits.push_back(atlas.uv(digits[i]));
+  assets.faceHappy = atlas.uv(faceHappy);
+  assets.faceO = atlas.uv(faceO);
+  assets.faceDead = atlas.uv(faceDead);
   assets.faceWin = assets.faceHappy;
-
-  assets.borderH = loadTexture(cfg.paths.borderH.c_str(), 32, 32);
-  assets.borderV = loadTexture(cfg.paths.borderV.c_str(), 32, 32);
-  assets.cornerTL = loadTexture(cfg.paths.cornerTL.c_str(), 32, 32);
-  assets.cornerTR = loadTexture(cfg.paths.cornerTR.c_str(), 32, 32);
-  assets.cornerBL = loadTexture(cfg.paths.cornerBL.c_str(), 32, 32);
-  assets.cornerBR = loadTexture(cfg.paths.cornerBR.c_str(), 32, 32);
-
+  assets.borderH = atlas.uv(borderH);
+  assets.borderV = atlas.uv(borderV);
+  assets.cornerTL = atlas.uv(cornerTL);
+  assets.cornerTR = atlas.uv(cornerTR);
+  assets.cornerBL = atlas.uv(cornerBL);
+  assets.cornerBR = atlas.uv(cornerBR);
+
+  solverWorker.setOnPublish([] { glfwPostEmptyEvent(); });
+  solverWorker.start();
+  if (!cfg.bots.sharedName.empty())
+    sharedHost.open(cfg.bots.sharedName, cfg.bots.sharedMaxCells);
   setDifficulty(Difficulty::BEGINNER);
 }
 
 void MinesweeperGame::setDifficulty(Difficulty d) {
   ctx.difficulty = d;
-  switch (d) {
-  case Difficulty::BEGINNER:
-    ctx.rows = 9;
-    ctx.cols = 9;
-    ctx.totalMines = 20;
-    break;
-  case Difficulty::INTERMEDIATE:
-    ctx.rows = 16;
-    ctx.cols = 16;
-    ctx.totalMines = 49;
-    break;
-  case Difficulty::EXPERT:
-    ctx.rows = 30;
-    ctx.cols = 30;
-    ctx.totalMines = 199;
-    break;
-  }
+  const DifficultyLevel &level = difficultyLevel(d);
+  ctx.rows = level.rows;
+  ctx.cols = level.cols;
+  ctx.totalMines = Board::defaultMineCount(ctx.rows, ctx.cols);
   ctx.state = GameState::PLAYING;
   ctx.gameStarted = false;
   ctx.startTime = 0;
@@ -79,17 +88,62 @@ void MinesweeperGame::setDifficulty(Difficulty d) {
 }
 
 void MinesweeperGame::resetBoard() {
+  board.reset(ctx.rows, ctx.cols, ctx.totalMines, std::random_device{}());
   tiles.resize(ctx.rows * ctx.cols);
   for (auto &t : tiles) {
-    t.symbol = ' ';
-    t.revealed = false;
-    t.flagged = false;
-    t.texture = assets.closed;
+    t.sprite = SPRITE_CLOSED;
     t.x = 0;
     t.y = 0;
     t.w = 0;
     t.h = 0;
   }
+  if (lastWidth > 0)
+    computeTileLayout(lastWidth, lastHeight, layout.headerH, layout.menuH,
+                      layout.borderTh);
+  board.setTrackChanges(true);
+  dirtyTiles.clear();
+  gridFullRefresh = true;
+  onBoardChanged();
+}
+
+// Updates the tiles of the cells the board reports as changed since the
+// last call and queues them for the grid.
+void MinesweeperGame::syncTileTextures() {
+  for (int i : board.getChanges()) {
+    const Cell &c = board.at(i);
+    dirtyTiles.push_back(i);
+    if (!c.revealed)
+      tiles[i].sprite = c.flagged ? SPRITE_FLAG : SPRITE_CLOSED;
+    else if (c.mine)
+      tiles[i].sprite = SPRITE_MINE;
+    else
+      tiles[i].sprite = SPRITE_NUMBER + c.adjacent;
+  }
+  board.clearChanges();
+}
+
+void MinesweeperGame::onBoardChanged() {
+  boardVersion++;
+  sharedHost.publish(board, elapsedSeconds());
+  if ((ctx.showHints || ctx.showHeatmap) && ctx.state == GameState::PLAYING)
+    solverWorker.submit(BoardView::of(board), boardVersion);
+}
+
+void MinesweeperGame::updateHintMarks() {
+  auto latest = solverWorker.latest();
+  if (latest == hintResult && hintMarksVersion == boardVersion)
+    return;
+  hintResult = latest;
+  hintMarksVersion = boardVersion;
+  hintMarksSerial++;
+  hintMarks.assign(tiles.size(), 0);
+  if (!hintResult || hintResult->version != boardVersion ||
+      hintResult->mineProbability.size() != tiles.size())
+    return;
+  for (int i : hintResult->safeCells)
+    hintMarks[i] = 1;
+  if (hintResult->safeCells.empty() && hintResult->bestGuess >= 0)
+    hintMarks[hintResult->bestGuess] = 2;
 }
 
 void MinesweeperGame::computeTileLayout(int windowWidth, int windowHeight,
@@ -142,36 +196,38 @@ void MinesweeperGame::handleInput(Window &window) {
   lastLeftMouseState = leftPressed;
   lastRightMouseState = rightPressed;
 
-  int windowWidth = window.getWidth();
-  int windowHeight = window.getHeight();
+  bool hintKey = window.isKeyPressed(GLFW_KEY_H);
+  if (hintKey && !lastHintKeyState) {
+    ctx.showHints = !ctx.showHints;
+    onBoardChanged();
+  }
+  lastHintKeyState = hintKey;
 
-  float uiScale = (float)windowHeight / cfg.ui.referenceHeight;
-  if (uiScale < cfg.ui.minScale)
-    uiScale = cfg.ui.minScale;
+  bool heatmapKey = window.isKeyPressed(GLFW_KEY_P);
+  if (heatmapKey && !lastHeatmapKeyState) {
+    ctx.showHeatmap = !ctx.showHeatmap;
+    onBoardChanged();
+  }
+  lastHeatmapKeyState = heatmapKey;
 
-  float currentHeaderH = cfg.ui.baseHeaderHeight * uiScale;
-  float currentMenuH = cfg.ui.baseMenuHeight * uiScale;
-  float currentFaceSize = cfg.ui.baseFaceSize * uiScale;
-  float gridTop = currentMenuH + currentHeaderH;
-  float menuBtnW = windowWidth / 3.0f;
+  applySharedCommands();
 
-  if (leftClicked && my < currentMenuH) {
-    if (mx < menuBtnW)
+  int windowWidth = window.getWidth();
+  int windowHeight = window.getHeight();
+  updateLayout(windowWidth, windowHeight);
+  const UILayout &l = layout;
+
+  if (leftClicked && my < l.menuH) {
+    if (mx < l.menuBtnW)
       setDifficulty(Difficulty::BEGINNER);
-    else if (mx < menuBtnW * 2)
+    else if (mx < l.menuBtnW * 2)
       setDifficulty(Difficulty::INTERMEDIATE);
     else
       setDifficulty(Difficulty::EXPERT);
-
-    float currentBorderTh = cfg.ui.baseBorderThickness * uiScale;
-    computeTileLayout(windowWidth, windowHeight, currentHeaderH, currentMenuH,
-                      currentBorderTh);
   }
 
-  float faceX = (windowWidth - currentFaceSize) * 0.5f;
-  float faceY = currentMenuH + (currentHeaderH - currentFaceSize) * 0.5f;
-  bool hoverFace = isPointInsideRect((float)mx, (float)my, faceX, faceY,
-                                     currentFaceSize, currentFaceSize);
+  bool hoverFace = isPointInsideRect((float)mx, (float)my, l.faceX, l.faceY,
+                                     l.faceSize, l.faceSize);
 
   if (!leftPressed && lastLeftMouseState && hoverFace) {
 
@@ -187,32 +243,71 @@ void MinesweeperGame::handleInput(Window &window) {
     return -1;
   };
 
-  if (ctx.state == GameState::PLAYING && my > gridTop) {
+  if (ctx.state == GameState::PLAYING && my > l.gridTop) {
     if (rightClicked) {
       int idx = findTileIndexAt(mx, my);
-      if (idx >= 0 && !tiles[idx].revealed) {
-        tiles[idx].flagged = !tiles[idx].flagged;
-        tiles[idx].texture = tiles[idx].flagged ? assets.flag : assets.closed;
-      }
+      if (idx >= 0)
+        flagCell(idx);
     }
     if (leftClicked) {
       int idx = findTileIndexAt(mx, my);
-      if (idx >= 0 && !tiles[idx].flagged && !tiles[idx].revealed) {
-        if (!ctx.gameStarted) {
-          ctx.gameStarted = true;
-          ctx.startTime = glfwGetTime();
-        }
-        RevealResult res = revealTileAt(idx);
-        if (res == RevealResult::GAME_OVER) {
-          ctx.state = GameState::LOST;
-          ctx.finalTime = glfwGetTime() - ctx.startTime;
-          processGameOver(idx);
-        } else if (res == RevealResult::WIN) {
-          ctx.state = GameState::WON;
-          ctx.finalTime = glfwGetTime() - ctx.startTime;
-        }
-      }
+      if (idx >= 0)
+        revealCell(idx, false);
+    }
+  }
+}
+
+void MinesweeperGame::flagCell(int idx) {
+  if (ctx.state != GameState::PLAYING || !board.toggleFlag(idx))
+    return;
+  syncTileTextures();
+  onBoardChanged();
+}
+
+void MinesweeperGame::revealCell(int idx, bool chord) {
+  if (ctx.state != GameState::PLAYING || board.at(idx).flagged ||
+      board.at(idx).revealed != chord)
+    return;
+  if (!ctx.gameStarted) {
+    ctx.gameStarted = true;
+    ctx.startTime = clock->now();
+  }
+  RevealResult res = chord ? board.chord(idx) : board.reveal(idx);
+  syncTileTextures();
+  if (res == RevealResult::GAME_OVER) {
+    ctx.state = GameState::LOST;
+    ctx.finalTime = clock->now() - ctx.startTime;
+    int hit = idx;
+    for (int i = 0; i < board.size(); ++i)
+      if (board.at(i).mine && board.at(i).revealed)
+        hit = i;
+    processGameOver(hit);
+  } else if (res == RevealResult::WIN) {
+    ctx.state = GameState::WON;
+    ctx.finalTime = clock->now() - ctx.startTime;
+  }
+  onBoardChanged();
+}
+
+// Restarting from a bot keeps the current difficulty; the requested size
+// and seed only apply to the headless host, but a size the segment cannot
+// hold is rejected here too.
+void MinesweeperGame::applySharedCommands() {
+  SharedCommand cmd;
+  while (sharedHost.poll(cmd)) {
+    if (cmd.op == SHM_NEW) {
+      if (sharedHost.fits(cmd))
+        setDifficulty(ctx.difficulty);
+      continue;
     }
+    if (cmd.cell >= (uint32_t)board.size())
+      continue;
+    if (cmd.op == SHM_REVEAL)
+      revealCell((int)cmd.cell, false);
+    else if (cmd.op == SHM_FLAG)
+      flagCell((int)cmd.cell);
+    else if (cmd.op == SHM_CHORD)
+      revealCell((int)cmd.cell, true);
   }
 }
 
@@ -223,58 +318,22 @@ void MinesweeperGame::render(const Window &window) {
   if (windowWidth < 1 || windowHeight < 1)
     return;
 
-  renderer.setProjection(shaderProgram, (float)windowWidth,
-                         (float)windowHeight);
-
-  float uiScale = (float)windowHeight / cfg.ui.referenceHeight;
-  if (uiScale < cfg.ui.minScale)
-    uiScale = cfg.ui.minScale;
-
-  float currentHeaderH = cfg.ui.baseHeaderHeight * uiScale;
-  float currentMenuH = cfg.ui.baseMenuHeight * uiScale;
-  float currentBorderTh = cfg.ui.baseBorderThickness * uiScale;
-  float currentFaceSize = cfg.ui.baseFaceSize * uiScale;
-
-  if (windowWidth != lastWidth || windowHeight != lastHeight) {
-    computeTileLayout(windowWidth, windowHeight, currentHeaderH, currentMenuH,
-                      currentBorderTh);
-
-    const_cast<MinesweeperGame *>(this)->lastWidth = windowWidth;
-    const_cast<MinesweeperGame *>(this)->lastHeight = windowHeight;
+  glState.beginFrame();
+  if (cfg.render.logStateStats && clock->now() - lastStatsLog >= 1.0) {
+    lastStatsLog = clock->now();
+    const GLStateCache::Stats &s = glState.lastFrame();
+    double stall =
+        renderer.getStreamStall() + textRenderer.getStreamStall();
+    std::cerr << "gl state: " << s.issued << " issued, " << s.elided
+              << " elided; stream stall " << stall * 1000.0 << " ms\n";
   }
 
-  float menuBtnW = windowWidth / 3.0f;
-  float btnPad = cfg.ui.buttonPadding * uiScale;
+  updateLayout(windowWidth, windowHeight);
+  const UILayout &l = layout;
 
-  drawBorderFrame(0 + btnPad, btnPad, menuBtnW - (btnPad * 2),
-                  currentMenuH - (btnPad * 2), currentBorderTh);
-  drawBorderFrame(menuBtnW + btnPad, btnPad, menuBtnW - (btnPad * 2),
-                  currentMenuH - (btnPad * 2), currentBorderTh);
-  drawBorderFrame(menuBtnW * 2 + btnPad, btnPad, menuBtnW - (btnPad * 2),
-                  currentMenuH - (btnPad * 2), currentBorderTh);
+  chrome.draw(shaderProgram, assets.atlas);
 
-  float textScale = uiScale * cfg.ui.fontScaleCorrection;
-  float textY = (currentMenuH + (cfg.ui.fontSize * textScale)) * 0.5f - 2.0f;
-  auto drawCenteredText = [&](std::string txt, float btnX, float btnW) {
-    float w = textRenderer.getWidth(txt, textScale);
-    float tx = btnX + (btnW - w) * 0.5f;
-    textRenderer.drawText(txt, tx, textY, textScale, cfg.colors.text[0],
-                          cfg.colors.text[1], cfg.colors.text[2],
-                          (float)windowWidth, (float)windowHeight);
-  };
-
-  drawCenteredText("BEGINNER", 0.0f, menuBtnW);
-  drawCenteredText("INTERMEDIATE", menuBtnW, menuBtnW);
-  drawCenteredText("EXPERT", menuBtnW * 2.0f, menuBtnW);
-
-  float headerY = currentMenuH;
-  drawBorderFrame(0, headerY, (float)windowWidth, currentHeaderH,
-                  currentBorderTh);
-
-  float faceX = (windowWidth - currentFaceSize) * 0.5f;
-  float faceY = headerY + (currentHeaderH - currentFaceSize) * 0.5f;
-
-  GLuint faceTex = assets.faceHappy;
+  UVRect faceTex = assets.faceHappy;
   if (ctx.state == GameState::LOST)
     faceTex = assets.faceDead;
   else if (ctx.state == GameState::WON)
@@ -284,61 +343,146 @@ void MinesweeperGame::render(const Window &window) {
     double mx, my;
     window.getCursorPos(mx, my);
 
-    bool hoverFace = isPointInsideRect((float)mx, (float)my, faceX, faceY,
-                                       currentFaceSize, currentFaceSize);
-    float gridTop = currentMenuH + currentHeaderH;
+    bool hoverFace = isPointInsideRect((float)mx, (float)my, l.faceX, l.faceY,
+                                       l.faceSize, l.faceSize);
 
     if (hoverFace)
       faceTex = assets.faceO;
-    else if (my > gridTop)
+    else if (my > l.gridTop)
       faceTex = assets.faceO;
   }
-  renderer.drawRect(shaderProgram, faceX, faceY, currentFaceSize,
-                    currentFaceSize, faceTex);
-
-  int flagsUsed = getFlaggedCount();
-  drawCounter(cfg.ui.counterSideMargin * uiScale,
-              headerY + (cfg.ui.counterTopMargin * uiScale),
-              ctx.totalMines - flagsUsed, uiScale);
+  renderer.drawRect(shaderProgram, l.faceX, l.faceY, l.faceSize, l.faceSize,
+                    assets.atlas, faceTex);
 
-  int seconds = (ctx.gameStarted && ctx.state == GameState::PLAYING)
-                    ? (int)(glfwGetTime() - ctx.startTime)
-                    : (int)ctx.finalTime;
+  int flagsUsed = board.getFlaggedCount();
+  drawCounter(l.mineCounterX, l.counterY, ctx.totalMines - flagsUsed,
+              l.scale);
+  drawCounter(l.timerX, l.counterY, displayedSeconds(), l.scale);
+  renderer.flush();
 
-  float timerTotalW =
-      ((cfg.ui.digitWidth * 3) + (cfg.ui.digitPadding * 2)) * uiScale;
-  float rightMargin = cfg.ui.counterSideMargin * uiScale;
-  drawCounter(windowWidth - timerTotalW - rightMargin,
-              headerY + (cfg.ui.counterTopMargin * uiScale), seconds, uiScale);
+  auto drawCenteredText = [&](std::string txt, float btnX, float btnW) {
+    float w = textRenderer.getWidth(txt, l.textScale);
+    float tx = btnX + (btnW - w) * 0.5f;
+    textRenderer.drawText(txt, tx, l.textY, l.textScale, cfg.colors.text[0],
+                          cfg.colors.text[1], cfg.colors.text[2]);
+  };
 
-  float gridTop = currentMenuH + currentHeaderH;
-  drawBorderFrame(0, gridTop, (float)windowWidth, (float)windowHeight - gridTop,
-                  currentBorderTh);
+  drawCenteredText("BEGINNER", 0.0f, l.menuBtnW);
+  drawCenteredText("INTERMEDIATE", l.menuBtnW, l.menuBtnW);
+  drawCenteredText("EXPERT", l.menuBtnW * 2.0f, l.menuBtnW);
 
   double mx, my;
   window.getCursorPos(mx, my);
 
-  for (auto &tile : tiles) {
-    if (tile.x + tile.w < 0 || tile.x > windowWidth || tile.y + tile.h < 0 ||
-        tile.y > windowHeight)
-      continue;
+  if (ctx.showHints || ctx.showHeatmap)
+    updateHintMarks();
+
+  // Hint marks can move anywhere, so a change to them revisits every cell;
+  // otherwise only the tiles touched since the last frame are.
+  bool showMarks = ctx.showHints && ctx.state == GameState::PLAYING;
+  auto setGridCell = [&](int i) {
+    uint8_t mark =
+        (showMarks && i < (int)hintMarks.size() && !board.at(i).flagged)
+            ? hintMarks[i]
+            : 0;
+    gridRenderer.set(i, tiles[i].sprite, (GridRenderer::Tint)mark);
+  };
+  if (gridFullRefresh || gridMarksSerial != hintMarksSerial ||
+      gridShowMarks != showMarks) {
+    gridRenderer.resize(ctx.rows, ctx.cols);
+    for (int i = 0; i < (int)tiles.size(); ++i)
+      setGridCell(i);
+    gridFullRefresh = false;
+    gridMarksSerial = hintMarksSerial;
+    gridShowMarks = showMarks;
+  } else {
+    for (int i : dirtyTiles)
+      setGridCell(i);
+  }
+  dirtyTiles.clear();
+
+  if (!tiles.empty()) {
+    const Tile &first = tiles.front();
+    int hoverCell = -1;
+    if (ctx.state == GameState::PLAYING && ctx.leftMouseHeld &&
+        my > l.gridTop && first.w > 0.0f) {
+      int cx = (int)std::floor((mx - first.x) / first.w);
+      int cy = (int)std::floor((my - first.y) / first.h);
+      if (cx >= 0 && cx < ctx.cols && cy >= 0 && cy < ctx.rows)
+        hoverCell = cy * ctx.cols + cx;
+    }
+    gridRenderer.draw(assets.tileSprites, first.x, first.y, first.w,
+                      hoverCell, cfg.hints.safeTint, cfg.hints.guessTint);
+  }
 
-    bool hover =
-        (my > gridTop) &&
-        isPointInsideRect((float)mx, (float)my, tile.x, tile.y, tile.w, tile.h);
-    GLuint textureToDraw = tile.texture;
-
-    if (ctx.state == GameState::PLAYING && !tile.revealed) {
-      if (tile.flagged)
-        textureToDraw = assets.flag;
-      else if (hover && ctx.leftMouseHeld)
-        textureToDraw = assets.hover;
-      else
-        textureToDraw = assets.closed;
+  if (ctx.showHeatmap && ctx.state == GameState::PLAYING && hintResult &&
+      hintResult->version == boardVersion && !tiles.empty()) {
+    if (heatmapVersion != boardVersion) {
+      heatmap.update(*hintResult, ctx.rows, ctx.cols);
+      heatmapVersion = boardVersion;
     }
-    renderer.drawRect(shaderProgram, tile.x, tile.y, tile.w, tile.h,
-                      textureToDraw);
+    const Tile &first = tiles.front();
+    const Tile &last = tiles.back();
+    renderer.drawRect(shaderProgram, first.x, first.y,
+                      last.x + last.w - first.x, last.y + last.h - first.y,
+                      heatmap.getTexture());
   }
+  renderer.flush();
+  renderer.endFrame();
+  textRenderer.endFrame();
+}
+
+double MinesweeperGame::elapsedSeconds() const {
+  if (!ctx.gameStarted)
+    return 0.0;
+  return ctx.state == GameState::PLAYING ? clock->now() - ctx.startTime
+                                         : ctx.finalTime;
+}
+
+int MinesweeperGame::displayedSeconds() const {
+  return (int)elapsedSeconds();
+}
+
+bool MinesweeperGame::FrameKey::operator==(const FrameKey &o) const {
+  return std::tie(width, height, mx, my, leftHeld, showHints, showHeatmap,
+                  state, boardVersion, seconds, hints) ==
+         std::tie(o.width, o.height, o.mx, o.my, o.leftHeld, o.showHints,
+                  o.showHeatmap, o.state, o.boardVersion, o.seconds, o.hints);
+}
+
+bool MinesweeperGame::needsRedraw(Window &window) {
+  FrameKey key;
+  key.width = window.getWidth();
+  key.height = window.getHeight();
+  key.leftHeld = ctx.leftMouseHeld;
+  // Without a held button the cursor changes nothing on screen.
+  if (key.leftHeld)
+    window.getCursorPos(key.mx, key.my);
+  key.showHints = ctx.showHints;
+  key.showHeatmap = ctx.showHeatmap;
+  key.state = ctx.state;
+  key.boardVersion = boardVersion;
+  key.seconds = displayedSeconds();
+  if (ctx.showHints || ctx.showHeatmap)
+    key.hints = solverWorker.latest().get();
+
+  bool refresh = window.takeRefreshRequest();
+  if (!refresh && key == lastFrame)
+    return false;
+  lastFrame = key;
+  return true;
+}
+
+double MinesweeperGame::idleTimeout() const {
+  double timeout = -1.0;
+  if (ctx.gameStarted && ctx.state == GameState::PLAYING) {
+    double elapsed = clock->now() - ctx.startTime;
+    timeout = 1.0 - std::fmod(elapsed, 1.0) + 0.001;
+  }
+  if (sharedHost.isOpen() &&
+      (timeout < 0.0 || timeout > cfg.bots.sharedPollSeconds))
+    timeout = cfg.bots.sharedPollSeconds;
+  return timeout;
 }
 
 void MinesweeperGame::drawCounter(float x, float y, int value, float scale) {
@@ -350,25 +494,65 @@ void MinesweeperGame::drawCounter(float x, float y, int value, float scale) {
   float w = cfg.ui.digitWidth * scale;
   float h = cfg.ui.digitHeight * scale;
   float pad = cfg.ui.digitPadding * scale;
-  renderer.drawRect(shaderProgram, x, y, w, h, assets.digits[d1]);
-  renderer.drawRect(shaderProgram, x + w + pad, y, w, h, assets.digits[d2]);
-  renderer.drawRect(shaderProgram, x + (w + pad) * 2, y, w, h,
+  GLuint atlas = assets.atlas;
+  renderer.drawRect(shaderProgram, x, y, w, h, atlas, assets.digits[d1]);
+  renderer.drawRect(shaderProgram, x + w + pad, y, w, h, atlas,
+                    assets.digits[d2]);
+  renderer.drawRect(shaderProgram, x + (w + pad) * 2, y, w, h, atlas,
                     assets.digits[d3]);
 }
 
-void MinesweeperGame::drawBorderFrame(float x, float y, float w, float h,
-                                      float th) {
-  renderer.drawRect(shaderProgram, x, y, th, th, assets.cornerTL);
-  renderer.drawRect(shaderProgram, x + w - th, y, th, th, assets.cornerTR);
-  renderer.drawRect(shaderProgram, x, y + h - th, th, th, assets.cornerBL);
-  renderer.drawRect(shaderProgram, x + w - th, y + h - th, th, th,
-                    assets.cornerBR);
-  renderer.drawRect(shaderProgram, x + th, y, w - 2 * th, th, assets.borderH);
-  renderer.drawRect(shaderProgram, x + th, y + h - th, w - 2 * th, th,
-                    assets.borderH);
-  renderer.drawRect(shaderProgram, x, y + th, th, h - 2 * th, assets.borderV);
-  renderer.drawRect(shaderProgram, x + w - th, y + th, th, h - 2 * th,
-                    assets.borderV);
+void MinesweeperGame::addBorderFrame(float x, float y, float w, float h,
+                                     float th) {
+  chrome.add(x, y, th, th, assets.cornerTL);
+  chrome.add(x + w - th, y, th, th, assets.cornerTR);
+  chrome.add(x, y + h - th, th, th, assets.cornerBL);
+  chrome.add(x + w - th, y + h - th, th, th, assets.cornerBR);
+  chrome.add(x + th, y, w - 2 * th, th, assets.borderH);
+  chrome.add(x + th, y + h - th, w - 2 * th, th, assets.borderH);
+  chrome.add(x, y + th, th, h - 2 * th, assets.borderV);
+  chrome.add(x + w - th, y + th, th, h - 2 * th, assets.borderV);
+}
+
+// Recomputes everything that depends only on the window size, including
+// the chrome mesh, when the size changes.
+void MinesweeperGame::updateLayout(int width, int height) {
+  if (width == lastWidth && height == lastHeight)
+    return;
+  lastWidth = width;
+  lastHeight = height;
+  projection.resize(width, height);
+
+  UILayout &l = layout;
+  l.scale = (float)height / cfg.ui.referenceHeight;
+  if (l.scale < cfg.ui.minScale)
+    l.scale = cfg.ui.minScale;
+  l.headerH = cfg.ui.baseHeaderHeight * l.scale;
+  l.menuH = cfg.ui.baseMenuHeight * l.scale;
+  l.borderTh = cfg.ui.baseBorderThickness * l.scale;
+  l.faceSize = cfg.ui.baseFaceSize * l.scale;
+  l.menuBtnW = width / 3.0f;
+  l.gridTop = l.menuH + l.headerH;
+  l.faceX = (width - l.faceSize) * 0.5f;
+  l.faceY = l.menuH + (l.headerH - l.faceSize) * 0.5f;
+  l.counterY = l.menuH + cfg.ui.counterTopMargin * l.scale;
+  l.mineCounterX = cfg.ui.counterSideMargin * l.scale;
+  float timerW = (cfg.ui.digitWidth * 3 + cfg.ui.digitPadding * 2) * l.scale;
+  l.timerX = width - timerW - cfg.ui.counterSideMargin * l.scale;
+  l.textScale = l.scale * cfg.ui.fontScaleCorrection;
+  l.textY = (l.menuH + cfg.ui.fontSize * l.textScale) * 0.5f - 2.0f;
+
+  computeTileLayout(width, height, l.headerH, l.menuH, l.borderTh);
+
+  chrome.clear();
+  float pad = cfg.ui.buttonPadding * l.scale;
+  for (int b = 0; b < 3; ++b)
+    addBorderFrame(l.menuBtnW * b + pad, pad, l.menuBtnW - pad * 2,
+                   l.menuH - pad * 2, l.borderTh);
+  addBorderFrame(0, l.menuH, (float)width, l.headerH, l.borderTh);
+  addBorderFrame(0, l.gridTop, (float)width, (float)height - l.gridTop,
+                 l.borderTh);
+  chrome.upload();
 }
 
 bool MinesweeperGame::isPointInsideRect(float px, float py, float x, float y,
@@ -376,191 +560,20 @@ bool MinesweeperGame::isPointInsideRect(float px, float py, float x, float y,
   return (px >= x && px <= x + w && py >= y && py <= y + h);
 }
 
-int MinesweeperGame::getFlaggedCount() const {
-  int count = 0;
-  for (const auto &t : tiles) {
-    if (t.flagged)
-      count++;
-  }
-  return count;
-}
-
-void MinesweeperGame::setTileContent(Tile &t, char symbol) {
-  t.symbol = symbol;
-  if (symbol == 'X') {
-    t.texture = assets.mine;
-  } else if (symbol >= '1' && symbol <= '8') {
-    t.texture = assets.numbers[symbol - '0'];
-  } else {
-    t.texture = assets.numbers[0];
-  }
-}
-
-int MinesweeperGame::countNeighborMines(int r, int c) {
-  const int dir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-                         {0, 1},   {1, -1}, {1, 0},  {1, 1}};
-  int count = 0;
-  for (auto &d : dir) {
-    int nr = r + d[0];
-    int nc = c + d[1];
-    if (nr >= 0 && nr < ctx.rows && nc >= 0 && nc < ctx.cols) {
-      if (tiles[rcToIndex(nr, nc, ctx.cols)].symbol == 'X')
-        count++;
-    }
-  }
-  return count;
-}
-
-void MinesweeperGame::generateGameOnFirstClick(int safeIndex, int totalMines) {
-  std::srand((unsigned int)std::time(nullptr));
-  int minesPlaced = 0;
-  int maxIndex = ctx.rows * ctx.cols;
-  if (totalMines > maxIndex - 9)
-    totalMines = maxIndex - 9;
-
-  std::vector<int> safeZone;
-  int safeR = safeIndex / ctx.cols;
-  int safeC = safeIndex % ctx.cols;
-  safeZone.push_back(safeIndex);
-
-  const int dir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-                         {0, 1},   {1, -1}, {1, 0},  {1, 1}};
-  for (auto &d : dir) {
-    int nr = safeR + d[0];
-    int nc = safeC + d[1];
-    if (nr >= 0 && nr < ctx.rows && nc >= 0 && nc < ctx.cols) {
-      safeZone.push_back(rcToIndex(nr, nc, ctx.cols));
-    }
-  }
-
-  while (minesPlaced < totalMines) {
-    int idx = std::rand() % maxIndex;
-    if (tiles[idx].symbol == 'X')
-      continue;
-    bool isSafe = false;
-    for (int s : safeZone) {
-      if (idx == s) {
-        isSafe = true;
-        break;
-      }
-    }
-    if (isSafe)
-      continue;
-    setTileContent(tiles[idx], 'X');
-    minesPlaced++;
-  }
-
-  for (int r = 0; r < ctx.rows; ++r) {
-    for (int c = 0; c < ctx.cols; ++c) {
-      int idx = rcToIndex(r, c, ctx.cols);
-      if (tiles[idx].symbol != 'X') {
-        int mines = countNeighborMines(r, c);
-        char sym = (mines == 0) ? ' ' : (char)('0' + mines);
-        setTileContent(tiles[idx], sym);
-      }
-    }
-  }
-}
-
-RevealResult MinesweeperGame::revealTileAt(int index) {
-  Tile &first = tiles[index];
-  if (first.flagged || first.revealed)
-    return RevealResult::CONTINUE;
-
-  bool boardIsBlank = true;
-  for (const auto &t : tiles) {
-    if (t.symbol == 'X') {
-      boardIsBlank = false;
-      break;
-    }
-  }
-
-  if (boardIsBlank) {
-    int totalCells = ctx.rows * ctx.cols;
-    int mineCount = (int)(totalCells * 0.15);
-    if (totalCells == 81)
-      mineCount = 10;
-    else if (totalCells == 256)
-      mineCount = 40;
-    else if (totalCells == 480)
-      mineCount = 99;
-    generateGameOnFirstClick(index, mineCount);
-  }
-
-  if (first.symbol == 'X') {
-    first.revealed = true;
-    first.texture = assets.mineRed;
-    return RevealResult::GAME_OVER;
-  }
-
-  std::queue<int> q;
-  q.push(index);
-  std::vector<bool> visited(tiles.size(), false);
-  visited[index] = true;
-
-  const int dir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-                         {0, 1},   {1, -1}, {1, 0},  {1, 1}};
-
-  while (!q.empty()) {
-    int cur = q.front();
-    q.pop();
-    Tile &t = tiles[cur];
-    if (t.flagged)
-      continue;
-
-    t.revealed = true;
-    if (t.symbol == 'X')
-      t.texture = assets.mine;
-    else if (t.symbol >= '1' && t.symbol <= '8')
-      t.texture = assets.numbers[t.symbol - '0'];
-    else
-      t.texture = assets.numbers[0];
-
-    if (t.symbol == ' ') {
-      int r = cur / ctx.cols;
-      int c = cur % ctx.cols;
-      for (auto &d : dir) {
-        int nr = r + d[0];
-        int nc = c + d[1];
-        if (nr < 0 || nr >= ctx.rows || nc < 0 || nc >= ctx.cols)
-          continue;
-        int ni = rcToIndex(nr, nc, ctx.cols);
-        if (!visited[ni] && !tiles[ni].revealed && !tiles[ni].flagged) {
-          visited[ni] = true;
-          q.push(ni);
-        }
-      }
-    }
-  }
-
-  for (auto &t : tiles) {
-    if (t.symbol != 'X' && !t.revealed)
-      return RevealResult::CONTINUE;
-  }
-  return RevealResult::WIN;
-}
-
 void MinesweeperGame::processGameOver(int clickedIndex) {
   for (int i = 0; i < (int)tiles.size(); ++i) {
     Tile &t = tiles[i];
-    if (i == clickedIndex) {
-      t.texture = assets.mineRed;
-      t.revealed = true;
-      continue;
-    }
-    if (t.flagged && t.symbol != 'X') {
-      t.texture = assets.wrongFlag;
-    } else if (t.symbol == 'X' && !t.flagged) {
-      t.texture = assets.mine;
-      t.revealed = true;
-    } else if (t.symbol != 'X' && !t.revealed && !t.flagged) {
-      int val = 0;
-      if (t.symbol >= '1' && t.symbol <= '8')
-        val = t.symbol - '0';
-      if (val > 0) {
-        t.texture = assets.yellowNumbers[val];
-        t.revealed = true;
-      }
-    }
+    const Cell &c = board.at(i);
+    uint8_t before = t.sprite;
+    if (i == clickedIndex)
+      t.sprite = SPRITE_MINE_RED;
+    else if (c.flagged && !c.mine)
+      t.sprite = SPRITE_WRONG_FLAG;
+    else if (c.mine && !c.flagged)
+      t.sprite = SPRITE_MINE;
+    else if (!c.mine && !c.revealed && !c.flagged && c.adjacent > 0)
+      t.sprite = SPRITE_YELLOW + c.adjacent;
+    if (t.sprite != before)
+      dirtyTiles.push_back(i);
   }
 }
@@ -0,0 +1,114 @@
+#include "../include/glState.hpp"
+
+GLStateCache glState;
+
+bool GLStateCache::changed(bool differs) {
+  if (differs)
+    current.issued++;
+  else
+    current.elided++;
+  return differs;
+}
+
+void GLStateCache::useProgram(GLuint prog) {
+  if (changed(prog != program)) {
+    glUseProgram(prog);
+    program = prog;
+  }
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+  if (changed(vao != vertexArray)) {
+    glBindVertexArray(vao);
+    vertexArray = vao;
+  }
+}
+
+// Units past kUnits and targets other than 2D and 2D array are not
+// shadowed and always bind.
+void GLStateCache::bindTexture(GLenum target, GLuint tex, int unit) {
+  if (changed(unit != activeUnit)) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    activeUnit = unit;
+  }
+  GLuint *bound = nullptr;
+  if (unit < kUnits && target == GL_TEXTURE_2D)
+    bound = &units[unit].tex2D;
+  else if (unit < kUnits && target == GL_TEXTURE_2D_ARRAY)
+    bound = &units[unit].tex2DArray;
+  if (changed(!bound || *bound != tex)) {
+    glBindTexture(target, tex);
+    if (bound)
+      *bound = tex;
+  }
+}
+
+// Deleting a bound object reverts its binding to 0, and GL may hand the
+// name out again, so the shadow state must forget it.
+void GLStateCache::deleteProgram(GLuint prog) {
+  if (!prog)
+    return;
+  glDeleteProgram(prog);
+  uniforms.erase(prog);
+  if (program == prog) {
+    glUseProgram(0);
+    program = 0;
+  }
+}
+
+void GLStateCache::deleteVertexArray(GLuint vao) {
+  if (!vao)
+    return;
+  glDeleteVertexArrays(1, &vao);
+  if (vertexArray == vao)
+    vertexArray = 0;
+}
+
+void GLStateCache::deleteTexture(GLuint tex) {
+  if (!tex)
+    return;
+  glDeleteTextures(1, &tex);
+  for (Unit &u : units) {
+    if (u.tex2D == tex)
+      u.tex2D = 0;
+    if (u.tex2DArray == tex)
+      u.tex2DArray = 0;
+  }
+}
+
+void GLStateCache::cacheUniforms(GLuint prog) {
+  auto &locations = uniforms[prog];
+  locations.clear();
+  GLint count = 0;
+  glGetProgramiv(prog, GL_ACTIVE_UNIFORMS, &count);
+  char name[256];
+  for (GLint i = 0; i < count; ++i) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(prog, (GLuint)i, sizeof(name), &length, &size, &type,
+                       name);
+    std::string key(name, length);
+    GLint loc = glGetUniformLocation(prog, key.c_str());
+    // Arrays are reported as "name[0]"; callers look them up by "name".
+    if (key.size() > 3 && key.compare(key.size() - 3, 3, "[0]") == 0)
+      key.resize(key.size() - 3);
+    locations[key] = loc;
+  }
+}
+
+GLint GLStateCache::uniform(GLuint prog, const char *name) {
+  auto &locations = uniforms[prog];
+  auto it = locations.find(name);
+  if (changed(it == locations.end())) {
+    GLint loc = glGetUniformLocation(prog, name);
+    locations.emplace(name, loc);
+    return loc;
+  }
+  return it->second;
+}
+
+void GLStateCache::beginFrame() {
+  last = current;
+  current = Stats();
+}
@@ -0,0 +1,130 @@
+#include "../include/gridRenderer.hpp"
+#include "../include/assets.hpp"
+#include "../include/glState.hpp"
+#include "../include/shader.hpp"
+#include <algorithm>
+
+// The grid shader keeps the sprite in the low 5 bits of a cell and swaps
+// layer 0 for layer 1 under the pressed cell.
+static_assert(SPRITE_COUNT <= 32, "sprite layers must fit in 5 bits");
+static_assert(SPRITE_CLOSED == 0 && SPRITE_HOVER == 1,
+              "grid shader hard-codes the closed and hover layers");
+
+GridRenderer::~GridRenderer() {
+  glState.deleteProgram(program);
+  glState.deleteVertexArray(vao);
+  glDeleteBuffers(1, &vbo);
+  glState.deleteTexture(cellTex);
+}
+
+void GridRenderer::init() {
+  program = Shader::createGridProgram();
+
+  glGenVertexArrays(1, &vao);
+  glGenBuffers(1, &vbo);
+  glState.bindVertexArray(vao);
+  float corners[] = {0, 0, 1, 0, 1, 1, 0, 1};
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
+                        (void *)0);
+  glEnableVertexAttribArray(0);
+
+  glGenTextures(1, &cellTex);
+  glState.bindTexture(GL_TEXTURE_2D, cellTex, 1);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void GridRenderer::resize(int r, int c) {
+  if (r == rows && c == cols)
+    return;
+  rows = r;
+  cols = c;
+  cells.assign((size_t)rows * cols, 0);
+  spanMin.assign(rows, cols);
+  spanMax.assign(rows, -1);
+  dirtyY1 = -1;
+
+  glState.bindTexture(GL_TEXTURE_2D, cellTex, 1);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, cols, rows, 0, GL_RED_INTEGER,
+               GL_UNSIGNED_BYTE, cells.data());
+}
+
+void GridRenderer::set(int index, uint8_t sprite, Tint tint) {
+  uint8_t v = (uint8_t)(sprite | tint << 5);
+  if (cells[index] == v)
+    return;
+  cells[index] = v;
+  int x = index % cols, y = index / cols;
+  spanMin[y] = std::min(spanMin[y], x);
+  spanMax[y] = std::max(spanMax[y], x);
+  if (dirtyY1 < 0) {
+    dirtyY0 = dirtyY1 = y;
+    return;
+  }
+  dirtyY0 = std::min(dirtyY0, y);
+  dirtyY1 = std::max(dirtyY1, y);
+}
+
+// A flood fill touches a block of consecutive rows and goes up as one
+// rectangle; isolated changes in distant rows go up separately instead of
+// as one rectangle spanning the board between them.
+void GridRenderer::upload() {
+  if (dirtyY1 < 0)
+    return;
+  glState.bindTexture(GL_TEXTURE_2D, cellTex, 1);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, cols);
+  int y = dirtyY0;
+  while (y <= dirtyY1) {
+    if (spanMax[y] < 0) {
+      y++;
+      continue;
+    }
+    int y0 = y, x0 = cols, x1 = -1;
+    for (; y <= dirtyY1 && spanMax[y] >= 0; ++y) {
+      x0 = std::min(x0, spanMin[y]);
+      x1 = std::max(x1, spanMax[y]);
+      spanMin[y] = cols;
+      spanMax[y] = -1;
+    }
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, x1 - x0 + 1, y - y0,
+                    GL_RED_INTEGER, GL_UNSIGNED_BYTE,
+                    &cells[(size_t)y0 * cols + x0]);
+  }
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  dirtyY1 = -1;
+}
+
+void GridRenderer::draw(GLuint spriteArray, float x, float y, float cellSize,
+                        int hoverCell, const float safeTint[4],
+                        const float guessTint[4]) {
+  if (cells.empty())
+    return;
+  upload();
+
+  glState.useProgram(program);
+  float tints[12] = {0, 0, 0, 0};
+  for (int k = 0; k < 4; ++k) {
+    tints[4 + k] = safeTint[k];
+    tints[8 + k] = guessTint[k];
+  }
+  glUniform4fv(glState.uniform(program, "tints"), 3, tints);
+  glUniform4f(glState.uniform(program, "rect"), x, y, cellSize * cols,
+              cellSize * rows);
+  glUniform2f(glState.uniform(program, "gridSize"), (float)cols,
+              (float)rows);
+  glUniform1i(glState.uniform(program, "hoverCell"), hoverCell);
+  glUniform1i(glState.uniform(program, "sprites"), 0);
+  glUniform1i(glState.uniform(program, "cells"), 1);
+  glState.bindTexture(GL_TEXTURE_2D_ARRAY, spriteArray, 0);
+  glState.bindTexture(GL_TEXTURE_2D, cellTex, 1);
+
+  glState.bindVertexArray(vao);
+  glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
@@ -0,0 +1,194 @@
+#include "../include/guessEngine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <thread>
+
+GuessEngine::GuessEngine(const GuessOptions &opts)
+    : opts(opts), hits(0), misses(0) {}
+
+void GuessEngine::clearCache() {
+  for (auto &s : shards) {
+    std::lock_guard<std::mutex> lock(s.mtx);
+    s.values.clear();
+  }
+  hits = 0;
+  misses = 0;
+}
+
+bool GuessEngine::lookup(const std::string &key, double &out) {
+  Shard &s = shards[std::hash<std::string>()(key) % kShards];
+  std::lock_guard<std::mutex> lock(s.mtx);
+  auto it = s.values.find(key);
+  if (it == s.values.end()) {
+    misses++;
+    return false;
+  }
+  hits++;
+  out = it->second;
+  return true;
+}
+
+void GuessEngine::store(const std::string &key, double v) {
+  Shard &s = shards[std::hash<std::string>()(key) % kShards];
+  std::lock_guard<std::mutex> lock(s.mtx);
+  s.values[key] = v;
+}
+
+std::vector<int> GuessEngine::candidates(const BoardView &view,
+                                         const SolveResult &res,
+                                         int count) const {
+  std::vector<int> cells;
+  for (int i = 0; i < (int)view.cells.size(); ++i)
+    if (view.cells[i] == CELL_UNKNOWN)
+      cells.push_back(i);
+  std::stable_sort(cells.begin(), cells.end(), [&](int a, int b) {
+    return res.mineProbability[a] < res.mineProbability[b];
+  });
+  if ((int)cells.size() > count)
+    cells.resize(count);
+  return cells;
+}
+
+// The cells alone do not identify a position: the same bytes can be laid
+// out in another shape or hold another number of mines.
+static std::string positionKey(const BoardView &view, int depth) {
+  int32_t header[4] = {view.rows, view.cols, view.mines, depth};
+  std::string key((const char *)header, sizeof(header));
+  key.append(view.cells.begin(), view.cells.end());
+  return key;
+}
+
+double GuessEngine::value(const BoardView &view, int depth, Solver &solver,
+                          const SolveResult *solved) {
+  std::string key = positionKey(view, depth);
+  double cached;
+  if (lookup(key, cached))
+    return cached;
+
+  SolveResult own;
+  if (!solved) {
+    solver.solve(view, own);
+    solved = &own;
+  }
+  const SolveResult &res = *solved;
+
+  double v;
+  bool anyUnknown = false;
+  for (int8_t c : view.cells)
+    if (c == CELL_UNKNOWN)
+      anyUnknown = true;
+
+  if (!res.consistent) {
+    v = 0.0;
+  } else if (!anyUnknown) {
+    v = 1.0;
+  } else if (depth <= 0) {
+    v = res.safeCells.empty() ? 1.0 - res.mineProbability[res.bestGuess]
+                              : 1.0;
+  } else if (!res.safeCells.empty()) {
+    v = expand(view, res.safeCells.front(), 1.0, depth, solver);
+  } else {
+    v = 0.0;
+    for (int c : candidates(view, res, opts.innerCandidates))
+      v = std::max(v, expand(view, c, 1.0 - res.mineProbability[c], depth,
+                             solver));
+  }
+
+  store(key, v);
+  return v;
+}
+
+// Expected win probability of revealing cell: the chance it is safe times
+// the value of each number it may show, weighted by the share of the
+// remaining layouts in which that number appears.
+double GuessEngine::expand(const BoardView &view, int cell,
+                           double safeProbability, int depth,
+                           Solver &solver) {
+  if (safeProbability <= 0.0)
+    return 0.0;
+
+  BoardView child = view;
+  double logWeight[9];
+  double maxLog = -std::numeric_limits<double>::infinity();
+  SolveResult res[9];
+  for (int n = 0; n <= 8; ++n) {
+    child.cells[cell] = (int8_t)n;
+    logWeight[n] = -std::numeric_limits<double>::infinity();
+    if (solver.solve(child, res[n]) && res[n].consistent) {
+      logWeight[n] = res[n].logWeight;
+      maxLog = std::max(maxLog, res[n].logWeight);
+    }
+  }
+  if (!std::isfinite(maxLog))
+    return 0.0;
+
+  double total = 0.0;
+  for (int n = 0; n <= 8; ++n)
+    if (std::isfinite(logWeight[n]))
+      total += std::exp(logWeight[n] - maxLog);
+
+  double v = 0.0;
+  for (int n = 0; n <= 8; ++n) {
+    if (!std::isfinite(logWeight[n]))
+      continue;
+    child.cells[cell] = (int8_t)n;
+    double p = std::exp(logWeight[n] - maxLog) / total;
+    v += p * value(child, depth - 1, solver, &res[n]);
+  }
+  return safeProbability * v;
+}
+
+int GuessEngine::choose(const BoardView &view,
+                        std::vector<GuessEvaluation> *evals) {
+  SampleOptions noSampling;
+  noSampling.deadlineMs = 0.0;
+
+  Solver solver(opts.maxSolverNodes);
+  solver.setSampleOptions(noSampling);
+  SolveResult res;
+  solver.solve(view, res);
+  if (evals)
+    evals->clear();
+  if (res.bestGuess < 0)
+    return -1;
+  if (!res.safeCells.empty()) {
+    if (evals)
+      evals->push_back({res.safeCells.front(), 1.0, 1.0});
+    return res.safeCells.front();
+  }
+
+  std::vector<int> cands = candidates(view, res, opts.rootCandidates);
+  std::vector<GuessEvaluation> results(cands.size());
+  std::atomic<int> next(0);
+  auto work = [&]() {
+    Solver local(opts.maxSolverNodes);
+    local.setSampleOptions(noSampling);
+    for (int i = next++; i < (int)cands.size(); i = next++) {
+      int c = cands[i];
+      double safe = 1.0 - res.mineProbability[c];
+      results[i] = {c, safe, expand(view, c, safe, opts.depth, local)};
+    }
+  };
+
+  int threads = opts.threads;
+  if (threads <= 0)
+    threads = (int)std::thread::hardware_concurrency();
+  threads = std::max(1, std::min(threads, (int)cands.size()));
+  std::vector<std::thread> workers;
+  for (int t = 1; t < threads; ++t)
+    workers.emplace_back(work);
+  work();
+  for (auto &w : workers)
+    w.join();
+
+  std::stable_sort(results.begin(), results.end(),
+                   [](const GuessEvaluation &a, const GuessEvaluation &b) {
+                     return a.winProbability > b.winProbability;
+                   });
+  if (evals)
+    *evals = results;
+  return results.front().cell;
+}
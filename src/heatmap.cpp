@@ -0,0 +1,75 @@
+#include "../include/heatmap.hpp"
+#include "../include/config.hpp"
+#include "../include/glState.hpp"
+#include <cstring>
+
+Heatmap::~Heatmap() {
+  glState.deleteTexture(tex);
+}
+
+void Heatmap::init() {
+  glGenTextures(1, &tex);
+  glState.bindTexture(GL_TEXTURE_2D, tex);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void Heatmap::update(const SolveResult &result, int r, int c) {
+  int n = r * c;
+  if ((int)result.mineProbability.size() != n)
+    return;
+
+  next.resize(n * 4);
+  for (int i = 0; i < n; ++i) {
+    float p = result.mineProbability[i];
+    unsigned char *px = &next[i * 4];
+    if (p < 0.0f) {
+      px[0] = px[1] = px[2] = px[3] = 0;
+      continue;
+    }
+    if (p > 1.0f)
+      p = 1.0f;
+    px[0] = (unsigned char)(255.0f * p);
+    px[1] = (unsigned char)(255.0f * (1.0f - p));
+    px[2] = 0;
+    px[3] = (unsigned char)(255.0f * cfg.hints.heatmapAlpha);
+  }
+
+  glState.bindTexture(GL_TEXTURE_2D, tex);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  if (r != rows || c != cols) {
+    rows = r;
+    cols = c;
+    pixels = next;
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cols, rows, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, pixels.data());
+    return;
+  }
+
+  int x0 = cols, y0 = rows, x1 = -1, y1 = -1;
+  for (int i = 0; i < n; ++i) {
+    if (std::memcmp(&next[i * 4], &pixels[i * 4], 4) == 0)
+      continue;
+    int y = i / cols, x = i % cols;
+    if (x < x0)
+      x0 = x;
+    if (x > x1)
+      x1 = x;
+    if (y < y0)
+      y0 = y;
+    if (y > y1)
+      y1 = y;
+  }
+  if (x1 < 0)
+    return;
+
+  pixels.swap(next);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, cols);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, x1 - x0 + 1, y1 - y0 + 1, GL_RGBA,
+                  GL_UNSIGNED_BYTE, &pixels[(y0 * cols + x0) * 4]);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
@@ -0,0 +1,292 @@
+#include "../include/laneBoard.hpp"
+#include <algorithm>
+#include <cstring>
+
+static const int kDir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+                               {0, 1},   {1, -1}, {1, 0},  {1, 1}};
+
+static const int L = LaneBoard::kLanes;
+
+// One byte per lane as a single vector, for the per-cell byte logic. Plain
+// loops over L vectorize at -O2, but -O3 unrolls them completely first and
+// ends up scalar.
+typedef uint8_t LaneBytes __attribute__((vector_size(L)));
+
+static inline LaneBytes loadLanes(const uint8_t *p) {
+  LaneBytes v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void storeLanes(uint8_t *p, LaneBytes v) {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+void LaneBoard::reset(int r, int c, int m, const uint64_t seeds[kLanes]) {
+  rows = r;
+  cols = c;
+  mines = std::max(0, std::min(m, rows * cols - 9));
+  size_t n = (size_t)rows * cols * L;
+  mine.assign(n, 0);
+  revealed.assign(n, 0);
+  flagged.assign(n, 0);
+  adjacent.assign(n, 0);
+  stack.reserve(rows * cols);
+  for (int l = 0; l < L; ++l) {
+    setSeed(l, seeds[l]);
+    revealedCount[l] = 0;
+    flaggedCount[l] = 0;
+    generated[l] = 0;
+    state[l] = (uint8_t)GameState::PLAYING;
+  }
+}
+
+void LaneBoard::resetLane(int lane, uint64_t s) {
+  for (int i = 0; i < size(); ++i) {
+    mine[i * L + lane] = 0;
+    revealed[i * L + lane] = 0;
+    flagged[i * L + lane] = 0;
+    adjacent[i * L + lane] = 0;
+  }
+  setSeed(lane, s);
+  revealedCount[lane] = 0;
+  flaggedCount[lane] = 0;
+  generated[lane] = 0;
+  state[lane] = (uint8_t)GameState::PLAYING;
+}
+
+int LaneBoard::countPlaying() const {
+  int n = 0;
+  for (int l = 0; l < L; ++l)
+    n += state[l] == (uint8_t)GameState::PLAYING;
+  return n;
+}
+
+static uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+static inline uint32_t fmix32(uint32_t x) {
+  x = (x ^ (x >> 16)) * 0x85ebca6bu;
+  x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+  return x ^ (x >> 16);
+}
+
+// The draw for a cell depends only on the lane's keys and the cell index,
+// so one pass over the cells draws for every lane with 32-bit vector ops.
+static inline uint32_t cellDraw(uint32_t key0, uint32_t key1, uint32_t i) {
+  return fmix32(fmix32(i * 0x9e3779b9u + key0) ^ key1);
+}
+
+static inline bool nearSafe(int r, int c, int safeR, int safeC) {
+  return (unsigned)(r - safeR + 1) <= 2u && (unsigned)(c - safeC + 1) <= 2u;
+}
+
+static int candidateCount(int rows, int cols, int safeIndex) {
+  int r = safeIndex / cols, c = safeIndex % cols;
+  int h = std::min(r + 1, rows - 1) - std::max(r - 1, 0) + 1;
+  int w = std::min(c + 1, cols - 1) - std::max(c - 1, 0) + 1;
+  return rows * cols - h * w;
+}
+
+void LaneBoard::setSeed(int lane, uint64_t s) {
+  uint64_t k = splitmix64(s);
+  key0[lane] = (uint32_t)k;
+  key1[lane] = (uint32_t)(k >> 32);
+}
+
+// Selection sampling: walking the cells in order, a candidate becomes a mine
+// with probability needed / remaining, which places exactly `mines` mines
+// uniformly over the candidates. Every lane runs the walk at once; lanes
+// not in this batch have nothing needed and keep their plane.
+void LaneBoard::generate(const int safeIndex[kLanes]) {
+  // Local copies, so writes to the mine plane cannot alias them and the
+  // lane loop vectorizes without a runtime overlap check.
+  int safeR[L], safeC[L];
+  uint32_t k0[L], k1[L], active[L], needed[L], remaining[L];
+  for (int l = 0; l < L; ++l) {
+    bool on = safeIndex[l] >= 0;
+    k0[l] = key0[l];
+    k1[l] = key1[l];
+    active[l] = on;
+    safeR[l] = on ? safeIndex[l] / cols : -8;
+    safeC[l] = on ? safeIndex[l] % cols : -8;
+    needed[l] = on ? (uint32_t)mines : 0;
+    remaining[l] = on ? (uint32_t)candidateCount(rows, cols, safeIndex[l]) : 0;
+    if (on)
+      generated[l] = 1;
+  }
+
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      uint32_t i = (uint32_t)(r * cols + c);
+      uint8_t *dst = &mine[i * L];
+      for (int l = 0; l < L; ++l) {
+        uint32_t cand = active[l] & !nearSafe(r, c, safeR[l], safeC[l]);
+        uint32_t u = cellDraw(k0[l], k1[l], i);
+        uint32_t take =
+            cand & ((uint32_t)(((uint64_t)u * remaining[l]) >> 32) <
+                    needed[l]);
+        needed[l] -= take;
+        remaining[l] -= cand;
+        dst[l] = active[l] ? (uint8_t)take : dst[l];
+      }
+    }
+  }
+}
+
+void LaneBoard::layout(int rows, int cols, int mines, uint64_t seed,
+                       int safeIndex, std::vector<int> &mineIndices) {
+  mines = std::max(0, std::min(mines, rows * cols - 9));
+  uint64_t k = splitmix64(seed);
+  uint32_t k0 = (uint32_t)k, k1 = (uint32_t)(k >> 32);
+  int safeR = safeIndex / cols, safeC = safeIndex % cols;
+  uint32_t needed = (uint32_t)mines;
+  uint32_t remaining = (uint32_t)candidateCount(rows, cols, safeIndex);
+  mineIndices.clear();
+  for (int i = 0; i < rows * cols && needed > 0; ++i) {
+    if (nearSafe(i / cols, i % cols, safeR, safeC))
+      continue;
+    uint32_t u = cellDraw(k0, k1, (uint32_t)i);
+    if ((uint32_t)(((uint64_t)u * remaining) >> 32) < needed) {
+      mineIndices.push_back(i);
+      needed--;
+    }
+    remaining--;
+  }
+}
+
+void LaneBoard::addAdjacency(int lane) {
+  for (int i = 0; i < rows * cols; ++i) {
+    if (!mine[i * L + lane])
+      continue;
+    int r = i / cols, c = i % cols;
+    for (auto &d : kDir) {
+      int nr = r + d[0];
+      int nc = c + d[1];
+      if (nr >= 0 && nr < rows && nc >= 0 && nc < cols)
+        adjacent[(nr * cols + nc) * L + lane]++;
+    }
+  }
+}
+
+// Recounts every lane at once; lanes that were already generated get the
+// same counts back.
+void LaneBoard::computeAdjacency() {
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      LaneBytes sum = {};
+      for (auto &d : kDir) {
+        int nr = r + d[0];
+        int nc = c + d[1];
+        if (nr >= 0 && nr < rows && nc >= 0 && nc < cols)
+          sum += loadLanes(&mine[(nr * cols + nc) * L]);
+      }
+      storeLanes(&adjacent[(r * cols + c) * L], sum);
+    }
+  }
+}
+
+RevealResult LaneBoard::reveal(int lane, int index) {
+  int first = index * L + lane;
+  if (flagged[first] || revealed[first])
+    return RevealResult::CONTINUE;
+  if (mine[first]) {
+    revealed[first] = 1;
+    state[lane] = (uint8_t)GameState::LOST;
+    return RevealResult::GAME_OVER;
+  }
+
+  stack.clear();
+  stack.push_back(index);
+  revealed[first] = 1;
+  while (!stack.empty()) {
+    int cur = stack.back();
+    stack.pop_back();
+    revealedCount[lane]++;
+    if (adjacent[cur * L + lane] != 0)
+      continue;
+
+    int r = cur / cols;
+    int c = cur % cols;
+    for (auto &d : kDir) {
+      int nr = r + d[0];
+      int nc = c + d[1];
+      if (nr < 0 || nr >= rows || nc < 0 || nc >= cols)
+        continue;
+      int n = (nr * cols + nc) * L + lane;
+      if (!revealed[n] && !flagged[n] && !mine[n]) {
+        revealed[n] = 1;
+        stack.push_back(nr * cols + nc);
+      }
+    }
+  }
+  return RevealResult::CONTINUE;
+}
+
+void LaneBoard::step(const Move actions[kLanes],
+                     RevealResult results[kLanes]) {
+  const uint8_t playing = (uint8_t)GameState::PLAYING;
+  int safeIndex[L];
+  int fresh = 0;
+  for (int l = 0; l < L; ++l) {
+    const Move &a = actions[l];
+    bool first = a.index >= 0 && !a.flag && !generated[l] &&
+                 state[l] == playing && !flagged[a.index * L + l];
+    safeIndex[l] = first ? a.index : -1;
+    if (first)
+      pending[fresh++] = l;
+  }
+  if (fresh > 0)
+    generate(safeIndex);
+  // A full recount is one vector add per neighbour per cell for all lanes;
+  // counting around each new mine is cheaper when only a few lanes are new.
+  if (fresh * 4 >= L) {
+    computeAdjacency();
+  } else {
+    for (int k = 0; k < fresh; ++k)
+      addAdjacency(pending[k]);
+  }
+
+  for (int l = 0; l < L; ++l) {
+    results[l] = RevealResult::CONTINUE;
+    const Move &a = actions[l];
+    if (a.index < 0 || state[l] != playing)
+      continue;
+    int i = a.index * L + l;
+    if (a.flag) {
+      if (!revealed[i]) {
+        flagged[i] ^= 1;
+        flaggedCount[l] += flagged[i] ? 1 : -1;
+      }
+      continue;
+    }
+    results[l] = reveal(l, a.index);
+  }
+
+  int safe = size() - mines;
+  for (int l = 0; l < L; ++l) {
+    bool won = state[l] == playing && revealedCount[l] == safe;
+    state[l] = won ? (uint8_t)GameState::WON : state[l];
+    results[l] = won ? RevealResult::WIN : results[l];
+  }
+}
+
+BoardView LaneBoard::view(int lane) const {
+  BoardView v;
+  v.rows = rows;
+  v.cols = cols;
+  v.mines = mines;
+  v.cells.resize(size());
+  for (int i = 0; i < size(); ++i) {
+    int k = i * L + lane;
+    if (revealed[k])
+      v.cells[i] = mine[k] ? (int8_t)CELL_FLAGGED : (int8_t)adjacent[k];
+    else
+      v.cells[i] = flagged[k] ? CELL_FLAGGED : CELL_UNKNOWN;
+  }
+  return v;
+}
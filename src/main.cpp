@@ -1,10 +1,31 @@
+#include "../include/botProtocol.hpp"
 #include "../include/config.hpp"
 #include "../include/gameState.hpp"
+#include "../include/sharedBoard.hpp"
 #include "../include/window.hpp"
+#include <cstdio>
+#include <cstring>
 
 Config cfg;
 
-int main() {
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--bot") == 0)
+      return BotProtocol(BotProtocol::Mode::TEXT).run(stdin, stdout);
+    if (std::strcmp(argv[i], "--bot-binary") == 0)
+      return BotProtocol(BotProtocol::Mode::BINARY).run(stdin, stdout);
+    if (std::strcmp(argv[i], "--bot-shm") == 0 && i + 1 < argc)
+      return serveShared(argv[i + 1]);
+    if (std::strcmp(argv[i], "--shm") == 0 && i + 1 < argc)
+      cfg.bots.sharedName = argv[++i];
+    if (std::strcmp(argv[i], "--gl-stats") == 0)
+      cfg.render.logStateStats = true;
+    if (std::strcmp(argv[i], "--frame-log") == 0)
+      cfg.render.logFrames = true;
+    if (std::strcmp(argv[i], "--no-persistent") == 0)
+      cfg.render.persistentBuffers = false;
+  }
+
   Window window(cfg.window.width, cfg.window.height, cfg.window.title,
                 cfg.window.resizable);
 
@@ -15,18 +36,33 @@ int main() {
   MinesweeperGame game;
   game.init();
 
+  // Draw only when something changed, and otherwise sleep until input, the
+  // next timer tick or a solver result.
+  MonotonicClock frameClock;
+  long frames = 0, idleWakeups = 0;
   while (!window.shouldClose()) {
     if (window.isKeyPressed(GLFW_KEY_ESCAPE)) {
       window.setShouldClose(true);
     }
 
-    glClearColor(cfg.colors.bg[0], cfg.colors.bg[1], cfg.colors.bg[2], 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-
     game.handleInput(window);
-    game.render(window);
+    if (game.needsRedraw(window)) {
+      glClearColor(cfg.colors.bg[0], cfg.colors.bg[1], cfg.colors.bg[2],
+                   1.0f);
+      glClear(GL_COLOR_BUFFER_BIT);
+      game.render(window);
+      window.present();
+
+      if (cfg.render.logFrames)
+        std::fprintf(stderr, "frame %ld at %.3fs, %ld idle wakeups skipped\n",
+                     frames, frameClock.now(), idleWakeups);
+      frames++;
+      idleWakeups = 0;
+    } else {
+      idleWakeups++;
+    }
 
-    window.update();
+    window.waitEvents(game.idleTimeout());
   }
 
   return 0;
@@ -0,0 +1,163 @@
+#include "../include/msapi.h"
+#include "../include/board.hpp"
+#include <algorithm>
+#include <memory>
+
+static_assert((int)MS_CELL_HIDDEN == (int)CODE_HIDDEN &&
+                  (int)MS_CELL_FLAGGED == (int)CODE_FLAGGED &&
+                  (int)MS_CELL_MINE == (int)CODE_MINE,
+              "ms_snapshot must use the Board::code() encoding");
+
+struct ms_board {
+  Board board;
+  std::vector<int> changes;
+};
+
+static int toResult(RevealResult r) {
+  return r == RevealResult::GAME_OVER ? MS_GAME_OVER
+         : r == RevealResult::WIN     ? MS_WIN
+                                      : MS_CONTINUE;
+}
+
+static bool validSize(int32_t rows, int32_t cols) {
+  return rows > 0 && cols > 0 && (int64_t)rows * cols <= MS_MAX_CELLS;
+}
+
+// Moves can allocate (mine placement, change tracking), so bad_alloc is
+// caught here rather than unwinding into the caller's runtime.
+static int applyMove(ms_board *b, int32_t cell, int32_t kind) {
+  if (!b || cell < 0 || cell >= b->board.size())
+    return MS_ERROR;
+  try {
+    switch (kind) {
+    case MS_MOVE_REVEAL:
+      return toResult(b->board.reveal(cell));
+    case MS_MOVE_FLAG:
+      b->board.toggleFlag(cell);
+      return MS_CONTINUE;
+    case MS_MOVE_CHORD:
+      return toResult(b->board.chord(cell));
+    default:
+      return MS_ERROR;
+    }
+  } catch (...) {
+    return MS_ERROR;
+  }
+}
+
+uint32_t ms_api_version(void) { return MS_API_VERSION; }
+
+ms_board *ms_board_new(int32_t rows, int32_t cols, int32_t mines,
+                       uint64_t seed) {
+  if (!validSize(rows, cols))
+    return nullptr;
+  try {
+    std::unique_ptr<ms_board> b(new ms_board());
+    b->board.reset(rows, cols, mines, seed);
+    return b.release();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void ms_board_free(ms_board *board) { delete board; }
+
+int ms_board_reset(ms_board *board, int32_t rows, int32_t cols,
+                   int32_t mines, uint64_t seed) {
+  if (!board || !validSize(rows, cols))
+    return MS_ERROR;
+  // Built aside so a failed allocation leaves the old board intact.
+  try {
+    Board fresh;
+    fresh.setTrackChanges(board->board.isTrackingChanges());
+    fresh.reset(rows, cols, mines, seed);
+    board->board = std::move(fresh);
+  } catch (...) {
+    return MS_ERROR;
+  }
+  board->changes.clear();
+  return 0;
+}
+
+int ms_board_info(const ms_board *board, ms_info *out) {
+  if (!board || !out)
+    return MS_ERROR;
+  const Board &b = board->board;
+  out->rows = b.getRows();
+  out->cols = b.getCols();
+  out->mines = b.getMineCount();
+  out->flags = b.getFlaggedCount();
+  out->state = (int32_t)b.getState();
+  return 0;
+}
+
+int ms_reveal(ms_board *board, int32_t cell) {
+  return applyMove(board, cell, MS_MOVE_REVEAL);
+}
+
+int ms_flag(ms_board *board, int32_t cell) {
+  return applyMove(board, cell, MS_MOVE_FLAG);
+}
+
+int ms_chord(ms_board *board, int32_t cell) {
+  return applyMove(board, cell, MS_MOVE_CHORD);
+}
+
+int ms_reveal_batch(ms_board *board, const ms_move *moves, int32_t n,
+                    int8_t *results) {
+  if (!board || !moves)
+    return 0;
+  int applied = 0;
+  while (applied < n && board->board.getState() == GameState::PLAYING) {
+    int r = applyMove(board, moves[applied].cell, moves[applied].kind);
+    if (results)
+      results[applied] = (int8_t)r;
+    applied++;
+  }
+  return applied;
+}
+
+int ms_step_boards(ms_board *const *boards, const ms_move *moves, int32_t n,
+                   int8_t *results) {
+  if (!boards || !moves)
+    return 0;
+  for (int32_t i = 0; i < n; ++i) {
+    int r = applyMove(boards[i], moves[i].cell, moves[i].kind);
+    if (results)
+      results[i] = (int8_t)r;
+  }
+  return n < 0 ? 0 : n;
+}
+
+int ms_snapshot(const ms_board *board, uint8_t *out, size_t cap) {
+  if (!board || !out || cap < (size_t)board->board.size())
+    return MS_ERROR;
+  const Board &b = board->board;
+  for (int i = 0; i < b.size(); ++i)
+    out[i] = b.code(i);
+  return b.size();
+}
+
+int ms_track_changes(ms_board *board, int enable) {
+  if (!board)
+    return MS_ERROR;
+  board->board.setTrackChanges(enable != 0);
+  board->board.clearChanges();
+  return 0;
+}
+
+int ms_take_changes(ms_board *board, int32_t *out, int32_t cap) {
+  if (!board || !out || cap <= 0)
+    return 0;
+  const std::vector<int> &log = board->board.getChanges();
+  try {
+    board->changes.insert(board->changes.end(), log.begin(), log.end());
+  } catch (...) {
+    return 0;
+  }
+  board->board.clearChanges();
+  int n = std::min((int)board->changes.size(), (int)cap);
+  std::copy(board->changes.begin(), board->changes.begin() + n, out);
+  board->changes.erase(board->changes.begin(), board->changes.begin() + n);
+  return n;
+}
@@ -0,0 +1,130 @@
+#include "../include/msenv.h"
+#include "../include/laneBoard.hpp"
+#include "../include/msapi.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+static const int L = LaneBoard::kLanes;
+
+static_assert(MSENV_MAX_CELLS == MS_MAX_CELLS,
+              "msenv and msapi must accept the same board sizes");
+
+struct MsEnv {
+  int count = 0;
+  int cells = 0;
+  std::vector<LaneBoard> groups;
+  Move actions[L];
+  RevealResult results[L];
+};
+
+static void writeObs(const MsEnv *env, int b, uint8_t *obs) {
+  if (!obs)
+    return;
+  const LaneBoard &g = env->groups[b / L];
+  int lane = b % L;
+  uint8_t *unknown = obs + (size_t)b * MSENV_PLANES * env->cells;
+  uint8_t *flag = unknown + env->cells;
+  uint8_t *number = flag + env->cells;
+  for (int i = 0; i < env->cells; ++i) {
+    bool open = g.isRevealed(lane, i);
+    bool flagged = g.isFlagged(lane, i);
+    unknown[i] = !open && !flagged;
+    flag[i] = flagged;
+    number[i] = open ? (uint8_t)g.adjacentMines(lane, i) : 0;
+  }
+}
+
+MsEnv *msenv_create(int n, int rows, int cols, int mines) {
+  if (n <= 0 || rows <= 0 || cols <= 0 ||
+      (int64_t)rows * cols > MSENV_MAX_CELLS)
+    return nullptr;
+  // The boards are allocated here, so bad_alloc is caught rather than
+  // unwinding into the caller's runtime.
+  try {
+    std::unique_ptr<MsEnv> env(new MsEnv());
+    env->count = n;
+    env->cells = rows * cols;
+    env->groups.resize((n + L - 1) / L);
+    uint64_t seeds[L] = {};
+    for (LaneBoard &g : env->groups)
+      g.reset(rows, cols, mines, seeds);
+    return env.release();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void msenv_destroy(MsEnv *env) { delete env; }
+
+int msenv_count(const MsEnv *env) { return env->count; }
+
+int msenv_obs_size(const MsEnv *env) { return MSENV_PLANES * env->cells; }
+
+int msenv_reset(MsEnv *env, const uint64_t *seeds, int n, uint8_t *obs) {
+  if (!env || n < 0 || n > env->count)
+    return -1;
+  for (int base = 0; base < n; base += L) {
+    LaneBoard &g = env->groups[base / L];
+    if (base + L <= n) {
+      g.reset(g.getRows(), g.getCols(), g.getMineCount(), seeds + base);
+    } else {
+      for (int b = base; b < n; ++b)
+        g.resetLane(b - base, seeds[b]);
+    }
+  }
+  for (int b = 0; b < n; ++b)
+    writeObs(env, b, obs);
+  return 0;
+}
+
+int msenv_reset_done(MsEnv *env, const uint64_t *seeds, int n, uint8_t *obs) {
+  if (!env || n < 0)
+    return -1;
+  if (n > env->count)
+    n = env->count;
+  int reset = 0;
+  for (int b = 0; b < n; ++b) {
+    LaneBoard &g = env->groups[b / L];
+    if (g.getState(b % L) == GameState::PLAYING)
+      continue;
+    g.resetLane(b % L, seeds[b]);
+    writeObs(env, b, obs);
+    reset++;
+  }
+  return reset;
+}
+
+int msenv_step(MsEnv *env, const int32_t *actions, int n, uint8_t *obs,
+               float *rewards, uint8_t *dones) {
+  if (!env || n < 0 || n > env->count)
+    return -1;
+  int cells = env->cells;
+  for (int base = 0; base < n; base += L) {
+    LaneBoard &g = env->groups[base / L];
+    int lanes = n - base < L ? n - base : L;
+    int before[L];
+    for (int l = 0; l < L; ++l) {
+      int32_t a = l < lanes ? actions[base + l] : -1;
+      if (a >= 2 * cells)
+        a = -1;
+      env->actions[l] = {a < cells ? a : a - cells, a >= cells};
+      before[l] = g.getRevealedCount(l);
+    }
+    g.step(env->actions, env->results);
+
+    int safe = g.size() - g.getMineCount();
+    for (int l = 0; l < lanes; ++l) {
+      int b = base + l;
+      if (rewards)
+        rewards[b] = env->results[l] == RevealResult::GAME_OVER
+                         ? -1.0f
+                         : (float)(g.getRevealedCount(l) - before[l]) / safe;
+      if (dones)
+        dones[b] = g.getState(l) != GameState::PLAYING;
+      if (env->actions[l].index >= 0)
+        writeObs(env, b, obs);
+    }
+  }
+  return 0;
+}
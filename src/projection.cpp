@@ -0,0 +1,44 @@
+#include "../include/projection.hpp"
+
+ProjectionBuffer::~ProjectionBuffer() { glDeleteBuffers(1, &ubo); }
+
+void ProjectionBuffer::init() {
+  glGenBuffers(1, &ubo);
+  glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+  glBufferData(GL_UNIFORM_BUFFER, 16 * sizeof(float), nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindBufferBase(GL_UNIFORM_BUFFER, kBinding, ubo);
+}
+
+// Maps (0, 0) to the top-left corner and (w, h) to the bottom-right.
+void ProjectionBuffer::resize(int w, int h) {
+  if (w < 1 || h < 1 || (w == width && h == height))
+    return;
+  width = w;
+  height = h;
+  float L = 0, R = (float)w, T = 0, B = (float)h;
+  float ortho[16] = {2.0f / (R - L),
+                     0.0f,
+                     0.0f,
+                     0.0f,
+                     0.0f,
+                     2.0f / (T - B),
+                     0.0f,
+                     0.0f,
+                     0.0f,
+                     0.0f,
+                     -1.0f,
+                     0.0f,
+                     -(R + L) / (R - L),
+                     -(T + B) / (T - B),
+                     0.0f,
+                     1.0f};
+  glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ortho), ortho);
+}
+
+void ProjectionBuffer::attach(GLuint prog) {
+  GLuint block = glGetUniformBlockIndex(prog, "Projection");
+  if (block != GL_INVALID_INDEX)
+    glUniformBlockBinding(prog, block, kBinding);
+}
@@ -0,0 +1,60 @@
+#include "../include/quadMesh.hpp"
+#include "../include/glState.hpp"
+
+QuadMesh::~QuadMesh() {
+  glState.deleteVertexArray(vao);
+  glDeleteBuffers(1, &vbo);
+  glDeleteBuffers(1, &ebo);
+}
+
+void QuadMesh::init() {
+  glGenVertexArrays(1, &vao);
+  glGenBuffers(1, &vbo);
+  glGenBuffers(1, &ebo);
+
+  glState.bindVertexArray(vao);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                        (void *)(2 * sizeof(float)));
+  glEnableVertexAttribArray(1);
+}
+
+void QuadMesh::add(float x, float y, float w, float h, const UVRect &uv) {
+  float x1 = x + w, y1 = y + h;
+  vertices.insert(vertices.end(), {x, y, uv.u0, uv.v0, x1, y, uv.u1, uv.v0, x1,
+                                   y1, uv.u1, uv.v1, x, y1, uv.u0, uv.v1});
+}
+
+void QuadMesh::upload() {
+  quadCount = vertices.size() / 16;
+  glState.bindVertexArray(vao);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
+               vertices.data(), GL_STATIC_DRAW);
+
+  if (quadCount > indexCapacity) {
+    indexCapacity = quadCount;
+    std::vector<unsigned int> indices;
+    indices.reserve(indexCapacity * 6);
+    for (size_t q = 0; q < indexCapacity; ++q) {
+      unsigned int b = (unsigned int)(q * 4);
+      indices.insert(indices.end(), {b, b + 1, b + 2, b + 2, b + 3, b});
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 indices.size() * sizeof(unsigned int), indices.data(),
+                 GL_STATIC_DRAW);
+  }
+}
+
+void QuadMesh::draw(GLuint prog, GLuint tex) {
+  if (quadCount == 0)
+    return;
+  glState.useProgram(prog);
+  glUniform1i(glState.uniform(prog, "tex"), 0);
+  glState.bindTexture(GL_TEXTURE_2D, tex);
+  glState.bindVertexArray(vao);
+  glDrawElements(GL_TRIANGLES, (GLsizei)(quadCount * 6), GL_UNSIGNED_INT, 0);
+}
@@ -0,0 +1,220 @@
+#include "../include/rating.hpp"
+#include "../include/satBackend.hpp"
+#include "../include/solver.hpp"
+#include <algorithm>
+
+namespace {
+
+const int kDir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+                        {0, 1},   {1, -1}, {1, 0},  {1, 1}};
+
+struct NumberInfo {
+  int cell;
+  int need;
+  std::vector<int> unknown;
+};
+
+void collectNumbers(const BoardView &view, std::vector<NumberInfo> &nums,
+                    std::vector<int> &numberAt) {
+  nums.clear();
+  numberAt.assign(view.cells.size(), -1);
+  for (int i = 0; i < (int)view.cells.size(); ++i) {
+    if (view.cells[i] < 0)
+      continue;
+    NumberInfo info{i, view.cells[i], {}};
+    int r = i / view.cols, c = i % view.cols;
+    for (auto &d : kDir) {
+      int nr = r + d[0], nc = c + d[1];
+      if (nr < 0 || nr >= view.rows || nc < 0 || nc >= view.cols)
+        continue;
+      int ni = nr * view.cols + nc;
+      if (view.cells[ni] == CELL_FLAGGED)
+        info.need--;
+      else if (view.cells[ni] == CELL_UNKNOWN)
+        info.unknown.push_back(ni);
+    }
+    if (info.unknown.empty())
+      continue;
+    numberAt[i] = (int)nums.size();
+    nums.push_back(info);
+  }
+}
+
+bool singleRule(const std::vector<NumberInfo> &nums, std::vector<int> &safe,
+                std::vector<int> &mines) {
+  for (const auto &n : nums) {
+    if (n.need == 0)
+      safe.insert(safe.end(), n.unknown.begin(), n.unknown.end());
+    else if (n.need == (int)n.unknown.size())
+      mines.insert(mines.end(), n.unknown.begin(), n.unknown.end());
+  }
+  return !safe.empty() || !mines.empty();
+}
+
+bool subsetRule(const BoardView &view, const std::vector<NumberInfo> &nums,
+                const std::vector<int> &numberAt, std::vector<int> &safe,
+                std::vector<int> &mines) {
+  std::vector<int> diff;
+  for (const auto &a : nums) {
+    int r = a.cell / view.cols, c = a.cell % view.cols;
+    // Numbers sharing an unknown are at most two cells apart.
+    for (int dr = -2; dr <= 2; ++dr) {
+      for (int dc = -2; dc <= 2; ++dc) {
+        int nr = r + dr, nc = c + dc;
+        if ((dr == 0 && dc == 0) || nr < 0 || nr >= view.rows || nc < 0 ||
+            nc >= view.cols)
+          continue;
+        int bi = numberAt[nr * view.cols + nc];
+        if (bi < 0)
+          continue;
+        const NumberInfo &b = nums[bi];
+        if (!std::includes(b.unknown.begin(), b.unknown.end(),
+                           a.unknown.begin(), a.unknown.end()))
+          continue;
+        diff.clear();
+        std::set_difference(b.unknown.begin(), b.unknown.end(),
+                            a.unknown.begin(), a.unknown.end(),
+                            std::back_inserter(diff));
+        if (diff.empty())
+          continue;
+        int extra = b.need - a.need;
+        if (extra == 0)
+          safe.insert(safe.end(), diff.begin(), diff.end());
+        else if (extra == (int)diff.size())
+          mines.insert(mines.end(), diff.begin(), diff.end());
+      }
+    }
+  }
+  return !safe.empty() || !mines.empty();
+}
+
+int countBbbv(const Board &board) {
+  int rows = board.getRows(), cols = board.getCols();
+  std::vector<bool> marked(board.size(), false);
+  std::vector<int> stack;
+  int clicks = 0;
+  for (int i = 0; i < board.size(); ++i) {
+    if (marked[i] || board.at(i).mine || board.at(i).adjacent != 0)
+      continue;
+    clicks++;
+    marked[i] = true;
+    stack.push_back(i);
+    while (!stack.empty()) {
+      int cur = stack.back();
+      stack.pop_back();
+      if (board.at(cur).adjacent != 0)
+        continue;
+      int r = cur / cols, c = cur % cols;
+      for (auto &d : kDir) {
+        int nr = r + d[0], nc = c + d[1];
+        if (nr < 0 || nr >= rows || nc < 0 || nc >= cols)
+          continue;
+        int ni = nr * cols + nc;
+        if (!marked[ni]) {
+          marked[ni] = true;
+          stack.push_back(ni);
+        }
+      }
+    }
+  }
+  for (int i = 0; i < board.size(); ++i)
+    if (!marked[i] && !board.at(i).mine)
+      clicks++;
+  return clicks;
+}
+
+} // namespace
+
+BoardRating rateBoard(int rows, int cols, int mines, uint64_t seed,
+                      int firstClick) {
+  BoardRating rating;
+  rating.seed = seed;
+
+  Board board;
+  board.reset(rows, cols, mines, seed);
+  board.reveal(firstClick);
+  rating.bbbv = countBbbv(board);
+
+  SampleOptions noSampling;
+  noSampling.deadlineMs = 0.0;
+  Solver solver;
+  solver.setSampleOptions(noSampling);
+
+  std::vector<NumberInfo> nums;
+  std::vector<int> numberAt, safe, mineCells;
+  while (board.getState() == GameState::PLAYING) {
+    BoardView view = BoardView::of(board);
+    safe.clear();
+    mineCells.clear();
+    collectNumbers(view, nums, numberAt);
+
+    DeductionRule rule = DeductionRule::NONE;
+    if (singleRule(nums, safe, mineCells)) {
+      rule = DeductionRule::SINGLE;
+    } else if (subsetRule(view, nums, numberAt, safe, mineCells)) {
+      rule = DeductionRule::SUBSET;
+    } else {
+      BoardView local = view;
+      local.mines = -1;
+      SatForced forced;
+      SatBackend::findForced(local, {}, forced);
+      if (forced.safeCells.empty() && forced.mineCells.empty()) {
+        SatBackend::findForced(view, {}, forced);
+        int unknown = 0;
+        for (int8_t c : view.cells)
+          if (c == CELL_UNKNOWN)
+            unknown++;
+        int remaining = view.mines - board.getFlaggedCount();
+        if (remaining == 0 || remaining == unknown)
+          for (int i = 0; i < (int)view.cells.size(); ++i)
+            if (view.cells[i] == CELL_UNKNOWN)
+              (remaining == 0 ? forced.safeCells : forced.mineCells)
+                  .push_back(i);
+        if (!forced.safeCells.empty() || !forced.mineCells.empty())
+          rule = DeductionRule::GLOBAL;
+      } else {
+        rule = DeductionRule::LOCAL;
+      }
+      safe = forced.safeCells;
+      mineCells = forced.mineCells;
+    }
+
+    if (rule == DeductionRule::NONE) {
+      SolveResult res;
+      solver.solve(view, res);
+      int pick = -1;
+      float risk = 2.0f;
+      for (int i = 0; i < board.size(); ++i) {
+        if (view.cells[i] != CELL_UNKNOWN)
+          continue;
+        float p = res.mineProbability[i];
+        risk = std::min(risk, p);
+        if (!board.at(i).mine &&
+            (pick < 0 || p < res.mineProbability[pick]))
+          pick = i;
+      }
+      if (pick < 0)
+        break;
+      rating.guesses++;
+      rating.survival *= 1.0 - risk;
+      board.reveal(pick);
+      continue;
+    }
+
+    if (rule > rating.deepestRule)
+      rating.deepestRule = rule;
+    if (rule >= DeductionRule::LOCAL)
+      rating.hardSteps++;
+    for (int m : mineCells)
+      if (!board.at(m).flagged)
+        board.toggleFlag(m);
+    for (int s : safe)
+      board.reveal(s);
+  }
+
+  rating.difficulty = (float)((int)rating.deepestRule +
+                              0.25 * rating.hardSteps +
+                              2.0 * rating.guesses +
+                              10.0 * (1.0 - rating.survival));
+  return rating;
+}
@@ -1,77 +1,15 @@
 #include "../include/renderer.hpp"
 
-Renderer::Renderer() : VAO(0), VBO(0), EBO(0) {}
-
-Renderer::~Renderer() {
-  glDeleteVertexArrays(1, &VAO);
-  glDeleteBuffers(1, &VBO);
-  glDeleteBuffers(1, &EBO);
-}
-
-void Renderer::init() {
-  glGenVertexArrays(1, &VAO);
-  glGenBuffers(1, &VBO);
-  glGenBuffers(1, &EBO);
-
-  glBindVertexArray(VAO);
-
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 16, nullptr, GL_DYNAMIC_DRAW);
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-  unsigned int indices[] = {0, 1, 2, 2, 3, 0};
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices,
-               GL_STATIC_DRAW);
-
-  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
-                        (void *)(2 * sizeof(float)));
-  glEnableVertexAttribArray(1);
-
-  glBindVertexArray(0);
-}
-
-void Renderer::updateQuad(float x, float y, float w, float h, float u0,
-                          float v0, float u1, float v1) {
-  float verts[] = {x,     y,     u0, v0, x + w, y,     u1, v0,
-                   x + w, y + h, u1, v1, x,     y + h, u0, v1};
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
-}
-
-void Renderer::setProjection(GLuint prog, int w, int h) {
-  glUseProgram(prog);
-  float L = 0, R = (float)w, T = 0, B = (float)h;
-  float ortho[16] = {2.0f / (R - L),
-                     0.0f,
-                     0.0f,
-                     0.0f,
-                     0.0f,
-                     2.0f / (T - B),
-                     0.0f,
-                     0.0f,
-                     0.0f,
-                     0.0f,
-                     -1.0f,
-                     0.0f,
-                     -(R + L) / (R - L),
-                     -(T + B) / (T - B),
-                     0.0f,
-                     1.0f};
-  glUniformMatrix4fv(glGetUniformLocation(prog, "projection"), 1, GL_FALSE,
-                     ortho);
+void Renderer::init(bool persistentStream) {
+  batch.init(persistentStream);
 }
 
 void Renderer::drawRect(GLuint prog, float x, float y, float w, float h,
                         unsigned int btnTex) {
-  glUseProgram(prog);
-
-  glUniform1i(glGetUniformLocation(prog, "tex"), 0);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, btnTex);
+  batch.add(prog, x, y, w, h, btnTex);
+}
 
-  glBindVertexArray(VAO);
-  updateQuad(x, y, w, h, 0, 0, 1, 1);
-  glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+void Renderer::drawRect(GLuint prog, float x, float y, float w, float h,
+                        GLuint tex, const UVRect &uv) {
+  batch.add(prog, x, y, w, h, tex, uv.u0, uv.v0, uv.u1, uv.v1);
 }
@@ -0,0 +1,333 @@
+#include "../include/sampler.hpp"
+#include "../include/bot.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+namespace {
+
+const int kDir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+                        {0, 1},   {1, -1}, {1, 0},  {1, 1}};
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t splitmix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+struct Problem {
+  int remaining = 0;
+  std::vector<int> unknown;
+  std::vector<int> need;
+  std::vector<std::vector<int>> cellCons;
+};
+
+struct ChainResult {
+  std::vector<double> counts;
+  long samples = 0;
+  int plays = 0;
+  int wins = 0;
+  bool found = false;
+};
+
+class Chain {
+public:
+  Chain(const Problem &p, uint64_t seed) : p(p), rng(seed) {}
+
+  void run(const BoardView &view, const SampleOptions &opts,
+           Clock::time_point deadline, const std::atomic<bool> *cancel,
+           ChainResult &out);
+
+private:
+  int cost(int c, int s) const { return std::abs(s - p.need[c]); }
+  int applySwap(int a, int b);
+  void revertSwap(int a, int b);
+  void commitSwap(int a, int b);
+  bool playout(const BoardView &view);
+
+  const Problem &p;
+  std::mt19937_64 rng;
+  std::vector<uint8_t> mine;
+  std::vector<int> mines, frees, slot, sums;
+};
+
+// Moves a mine from unknown cell a to b, returning the change in the number
+// of violated constraint units. Shared constraints cancel out naturally.
+int Chain::applySwap(int a, int b) {
+  int d = 0;
+  for (int c : p.cellCons[a]) {
+    d -= cost(c, sums[c]);
+    d += cost(c, --sums[c]);
+  }
+  for (int c : p.cellCons[b]) {
+    d -= cost(c, sums[c]);
+    d += cost(c, ++sums[c]);
+  }
+  return d;
+}
+
+void Chain::revertSwap(int a, int b) {
+  for (int c : p.cellCons[a])
+    sums[c]++;
+  for (int c : p.cellCons[b])
+    sums[c]--;
+}
+
+void Chain::commitSwap(int a, int b) {
+  mine[a] = 0;
+  mine[b] = 1;
+  int sa = slot[a], sb = slot[b];
+  mines[sa] = b;
+  frees[sb] = a;
+  slot[a] = sb;
+  slot[b] = sa;
+}
+
+bool Chain::playout(const BoardView &view) {
+  std::vector<int> layout;
+  for (int i = 0; i < (int)view.cells.size(); ++i)
+    if (view.cells[i] == CELL_FLAGGED)
+      layout.push_back(i);
+  for (int m : mines)
+    layout.push_back(p.unknown[m]);
+
+  Board board;
+  board.reset(view.rows, view.cols, (int)layout.size(), 0);
+  board.placeMines(layout);
+  for (int i = 0; i < (int)view.cells.size(); ++i)
+    if (view.cells[i] == CELL_FLAGGED)
+      board.toggleFlag(i);
+  for (int i = 0; i < (int)view.cells.size(); ++i)
+    if (view.cells[i] >= 0)
+      board.reveal(i);
+
+  Bot bot;
+  return bot.play(board, rng);
+}
+
+void Chain::run(const BoardView &view, const SampleOptions &opts,
+                Clock::time_point deadline, const std::atomic<bool> *cancel,
+                ChainResult &out) {
+  int u = (int)p.unknown.size();
+  int k = p.remaining;
+  out.counts.assign(u, 0.0);
+
+  std::vector<int> order(u);
+  for (int i = 0; i < u; ++i)
+    order[i] = i;
+  for (int i = u - 1; i > 0; --i)
+    std::swap(order[i], order[rng() % (uint64_t)(i + 1)]);
+
+  mine.assign(u, 0);
+  slot.assign(u, 0);
+  sums.assign(p.need.size(), 0);
+  mines.clear();
+  frees.clear();
+  for (int i = 0; i < u; ++i) {
+    int cell = order[i];
+    if (i < k) {
+      mine[cell] = 1;
+      slot[cell] = (int)mines.size();
+      mines.push_back(cell);
+      for (int c : p.cellCons[cell])
+        sums[c]++;
+    } else {
+      slot[cell] = (int)frees.size();
+      frees.push_back(cell);
+    }
+  }
+  int energy = 0;
+  for (size_t c = 0; c < p.need.size(); ++c)
+    energy += cost((int)c, sums[c]);
+
+  auto stopped = [&]() {
+    return Clock::now() >= deadline ||
+           (cancel && cancel->load(std::memory_order_relaxed));
+  };
+
+  bool movable = !mines.empty() && !frees.empty();
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  // Metropolis on the number of violated constraint units. A single swap
+  // often cannot get from one valid layout to another, so the chain is
+  // allowed through invalid states; counting only the sweeps that end with
+  // zero violations still weights every valid layout equally.
+  auto step = [&](double temperature) {
+    int a = mines[rng() % (uint64_t)mines.size()];
+    int b = frees[rng() % (uint64_t)frees.size()];
+    int d = applySwap(a, b);
+    if (d <= 0 || unit(rng) < std::exp(-d / temperature)) {
+      commitSwap(a, b);
+      energy += d;
+    } else {
+      revertSwap(a, b);
+    }
+  };
+
+  double temperature = 2.0;
+  long iter = 0;
+  while (energy > 0) {
+    if (!movable || ((++iter & 255) == 0 && stopped()))
+      return;
+    step(temperature);
+    temperature = std::max(opts.temperature, temperature * 0.9995);
+  }
+  out.found = true;
+
+  long sweeps = 0;
+  int sweepLen = u > 0 ? u : 1;
+  for (;;) {
+    for (int s = 0; movable && s < sweepLen; ++s)
+      step(opts.temperature);
+    if ((++sweeps > opts.burnInSweeps || !movable) && energy == 0) {
+      for (int m : mines)
+        out.counts[m] += 1.0;
+      out.samples++;
+      if (out.plays < opts.playouts) {
+        out.plays++;
+        if (playout(view))
+          out.wins++;
+      }
+    }
+    if (!movable || stopped())
+      return;
+  }
+}
+
+} // namespace
+
+bool Sampler::estimate(const BoardView &view, const SampleOptions &opts,
+                       SampleResult &out, const std::atomic<bool> *cancel) {
+  int n = view.rows * view.cols;
+  out.mineProbability.assign(n, -1.0f);
+  out.winProbability = -1.0;
+  out.rHat = 0.0;
+  out.converged = false;
+  out.samples = 0;
+
+  Problem p;
+  std::vector<int> local(n, -1);
+  int flags = 0;
+  for (int i = 0; i < n; ++i) {
+    if (view.cells[i] == CELL_UNKNOWN) {
+      local[i] = (int)p.unknown.size();
+      p.unknown.push_back(i);
+    } else if (view.cells[i] == CELL_FLAGGED) {
+      flags++;
+    }
+  }
+  p.remaining = view.mines - flags;
+  int u = (int)p.unknown.size();
+  if (p.remaining < 0 || p.remaining > u)
+    return false;
+
+  p.cellCons.resize(u);
+  for (int i = 0; i < n; ++i) {
+    if (view.cells[i] < 0)
+      continue;
+    int need = view.cells[i];
+    int c = (int)p.need.size();
+    bool any = false;
+    int r = i / view.cols, col = i % view.cols;
+    for (auto &d : kDir) {
+      int nr = r + d[0], nc = col + d[1];
+      if (nr < 0 || nr >= view.rows || nc < 0 || nc >= view.cols)
+        continue;
+      int ni = nr * view.cols + nc;
+      if (view.cells[ni] == CELL_FLAGGED) {
+        need--;
+      } else if (view.cells[ni] == CELL_UNKNOWN) {
+        p.cellCons[local[ni]].push_back(c);
+        any = true;
+      }
+    }
+    if (need < 0)
+      return false;
+    if (any)
+      p.need.push_back(need);
+  }
+
+  int chains = opts.chains;
+  if (chains <= 0)
+    chains = (int)std::thread::hardware_concurrency();
+  if (chains < 2)
+    chains = 2;
+  out.chains = chains;
+
+  auto deadline =
+      Clock::now() + std::chrono::microseconds((long)(opts.deadlineMs * 1000));
+  std::vector<ChainResult> results(chains);
+  std::vector<std::thread> workers;
+  for (int j = 0; j < chains; ++j) {
+    workers.emplace_back([&, j]() {
+      Chain chain(p, splitmix64(opts.seed + (uint64_t)j));
+      chain.run(view, opts, deadline, cancel, results[j]);
+    });
+  }
+  for (auto &w : workers)
+    w.join();
+
+  if (cancel && cancel->load())
+    return false;
+
+  std::vector<double> total(u, 0.0);
+  int used = 0, plays = 0, wins = 0;
+  long minSamples = -1;
+  for (auto &res : results) {
+    if (!res.found || res.samples == 0)
+      continue;
+    used++;
+    out.samples += res.samples;
+    plays += res.plays;
+    wins += res.wins;
+    for (int i = 0; i < u; ++i)
+      total[i] += res.counts[i];
+    if (minSamples < 0 || res.samples < minSamples)
+      minSamples = res.samples;
+  }
+  if (used == 0)
+    return false;
+
+  for (int i = 0; i < u; ++i)
+    out.mineProbability[p.unknown[i]] = (float)(total[i] / out.samples);
+  if (plays > 0)
+    out.winProbability = (double)wins / plays;
+
+  if (used >= 2 && minSamples > 1) {
+    double worst = 1.0;
+    for (int i = 0; i < u; ++i) {
+      double meanOfMeans = 0.0, within = 0.0;
+      std::vector<double> means;
+      for (auto &res : results) {
+        if (!res.found || res.samples == 0)
+          continue;
+        double m = res.counts[i] / res.samples;
+        means.push_back(m);
+        meanOfMeans += m;
+        within += m * (1.0 - m) * res.samples / (res.samples - 1.0);
+      }
+      meanOfMeans /= used;
+      within /= used;
+      if (within <= 0.0)
+        continue;
+      double between = 0.0;
+      for (double m : means)
+        between += (m - meanOfMeans) * (m - meanOfMeans);
+      between = between * minSamples / (used - 1);
+      double pooled = (minSamples - 1.0) / minSamples * within +
+                      between / minSamples;
+      double r = std::sqrt(pooled / within);
+      if (r > worst)
+        worst = r;
+    }
+    out.rHat = worst;
+    out.converged = worst <= opts.targetRHat;
+  }
+  return true;
+}
@@ -0,0 +1,338 @@
+#include "../include/sat.hpp"
+#include <algorithm>
+
+static long luby(long i) {
+  long size = 1, seq = 0;
+  while (size < i + 1) {
+    seq++;
+    size = 2 * size + 1;
+  }
+  while (size - 1 != i) {
+    size = (size - 1) >> 1;
+    seq--;
+    i = i % size;
+  }
+  return 1L << seq;
+}
+
+int SatSolver::newVar() {
+  int v = (int)assigns.size();
+  assigns.push_back(-1);
+  polarity.push_back(1);
+  level.push_back(0);
+  reason.push_back(-1);
+  activity.push_back(0.0);
+  heapIndex.push_back(-1);
+  seen.push_back(0);
+  watches.emplace_back();
+  watches.emplace_back();
+  heapInsert(v);
+  return v + 1;
+}
+
+void SatSolver::attach(int c) {
+  watches[clauses[c].lits[0]].push_back(c);
+  watches[clauses[c].lits[1]].push_back(c);
+}
+
+bool SatSolver::addClause(const std::vector<int> &dimacs) {
+  if (!ok)
+    return false;
+  std::vector<int> lits;
+  for (int d : dimacs)
+    lits.push_back(toLit(d));
+  std::sort(lits.begin(), lits.end());
+
+  std::vector<int> kept;
+  for (size_t i = 0; i < lits.size(); ++i) {
+    int l = lits[i];
+    if (value(l) == 1 || (i + 1 < lits.size() && lits[i + 1] == (l ^ 1)))
+      return true;
+    if (value(l) == 0 || (!kept.empty() && kept.back() == l))
+      continue;
+    kept.push_back(l);
+  }
+
+  if (kept.empty()) {
+    ok = false;
+    return false;
+  }
+  if (kept.size() == 1) {
+    enqueue(kept[0], -1);
+    if (propagate() >= 0)
+      ok = false;
+    return ok;
+  }
+  clauses.push_back({kept, false});
+  attach((int)clauses.size() - 1);
+  return true;
+}
+
+void SatSolver::enqueue(int lit, int why) {
+  int v = lit >> 1;
+  assigns[v] = (int8_t)((lit & 1) ^ 1);
+  level[v] = decisionLevel();
+  reason[v] = why;
+  trail.push_back(lit);
+}
+
+// Returns the index of a conflicting clause, or -1.
+int SatSolver::propagate() {
+  while (qhead < trail.size()) {
+    int falseLit = trail[qhead++] ^ 1;
+    propagations++;
+    std::vector<int> &ws = watches[falseLit];
+    size_t i = 0, j = 0;
+    while (i < ws.size()) {
+      int ci = ws[i++];
+      std::vector<int> &lits = clauses[ci].lits;
+      if (lits[0] == falseLit)
+        std::swap(lits[0], lits[1]);
+      if (value(lits[0]) == 1) {
+        ws[j++] = ci;
+        continue;
+      }
+
+      bool moved = false;
+      for (size_t k = 2; k < lits.size(); ++k) {
+        if (value(lits[k]) != 0) {
+          std::swap(lits[1], lits[k]);
+          watches[lits[1]].push_back(ci);
+          moved = true;
+          break;
+        }
+      }
+      if (moved)
+        continue;
+
+      ws[j++] = ci;
+      if (value(lits[0]) == 0) {
+        while (i < ws.size())
+          ws[j++] = ws[i++];
+        ws.resize(j);
+        qhead = trail.size();
+        return ci;
+      }
+      enqueue(lits[0], ci);
+    }
+    ws.resize(j);
+  }
+  return -1;
+}
+
+void SatSolver::analyze(int conflict, std::vector<int> &learnt,
+                        int &backLevel) {
+  learnt.assign(1, 0);
+  int pathCount = 0;
+  int p = -1;
+  int idx = (int)trail.size() - 1;
+
+  do {
+    const std::vector<int> &lits = clauses[conflict].lits;
+    for (size_t k = (p < 0 ? 0 : 1); k < lits.size(); ++k) {
+      int q = lits[k];
+      int v = q >> 1;
+      if (seen[v] || level[v] == 0)
+        continue;
+      seen[v] = 1;
+      bump(v);
+      if (level[v] == decisionLevel())
+        pathCount++;
+      else
+        learnt.push_back(q);
+    }
+    while (!seen[trail[idx] >> 1])
+      idx--;
+    p = trail[idx--];
+    conflict = reason[p >> 1];
+    seen[p >> 1] = 0;
+    pathCount--;
+  } while (pathCount > 0);
+  learnt[0] = p ^ 1;
+
+  backLevel = 0;
+  size_t maxAt = 1;
+  for (size_t k = 1; k < learnt.size(); ++k) {
+    int lv = level[learnt[k] >> 1];
+    if (lv > backLevel) {
+      backLevel = lv;
+      maxAt = k;
+    }
+  }
+  if (learnt.size() > 1)
+    std::swap(learnt[1], learnt[maxAt]);
+  for (int l : learnt)
+    seen[l >> 1] = 0;
+}
+
+void SatSolver::backtrack(int lv) {
+  if (decisionLevel() <= lv)
+    return;
+  for (int i = (int)trail.size() - 1; i >= trailLim[lv]; --i) {
+    int v = trail[i] >> 1;
+    polarity[v] = (int8_t)(trail[i] & 1);
+    assigns[v] = -1;
+    reason[v] = -1;
+    if (heapIndex[v] < 0)
+      heapInsert(v);
+  }
+  trail.resize(trailLim[lv]);
+  trailLim.resize(lv);
+  qhead = trail.size();
+}
+
+int SatSolver::pickBranch() {
+  while (!heap.empty()) {
+    int v = heapPop();
+    if (assigns[v] < 0)
+      return 2 * v + polarity[v];
+  }
+  return -1;
+}
+
+void SatSolver::bump(int v) {
+  activity[v] += varInc;
+  if (activity[v] > 1e100) {
+    for (double &a : activity)
+      a *= 1e-100;
+    varInc *= 1e-100;
+  }
+  if (heapIndex[v] >= 0)
+    heapUp(heapIndex[v]);
+}
+
+void SatSolver::heapInsert(int v) {
+  heapIndex[v] = (int)heap.size();
+  heap.push_back(v);
+  heapUp(heapIndex[v]);
+}
+
+void SatSolver::heapUp(int pos) {
+  int v = heap[pos];
+  while (pos > 0) {
+    int parent = (pos - 1) / 2;
+    if (activity[heap[parent]] >= activity[v])
+      break;
+    heap[pos] = heap[parent];
+    heapIndex[heap[pos]] = pos;
+    pos = parent;
+  }
+  heap[pos] = v;
+  heapIndex[v] = pos;
+}
+
+void SatSolver::heapDown(int pos) {
+  int v = heap[pos];
+  int n = (int)heap.size();
+  for (;;) {
+    int child = 2 * pos + 1;
+    if (child >= n)
+      break;
+    if (child + 1 < n && activity[heap[child + 1]] > activity[heap[child]])
+      child++;
+    if (activity[heap[child]] <= activity[v])
+      break;
+    heap[pos] = heap[child];
+    heapIndex[heap[pos]] = pos;
+    pos = child;
+  }
+  heap[pos] = v;
+  heapIndex[v] = pos;
+}
+
+int SatSolver::heapPop() {
+  int top = heap[0];
+  heapIndex[top] = -1;
+  int last = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    heap[0] = last;
+    heapIndex[last] = 0;
+    heapDown(0);
+  }
+  return top;
+}
+
+SatSolver::Result SatSolver::solve(const std::vector<int> &assumptions,
+                                   long conflictBudget,
+                                   const std::atomic<bool> *cancel) {
+  if (!ok)
+    return Result::UNSAT;
+
+  std::vector<int> assume;
+  for (int d : assumptions)
+    assume.push_back(toLit(d));
+
+  std::vector<int> learnt;
+  long restart = 0;
+  long untilRestart = 100 * luby(restart);
+  long budgetEnd = conflictBudget < 0 ? -1 : conflicts + conflictBudget;
+  Result result = Result::UNKNOWN;
+
+  for (;;) {
+    int conflict = propagate();
+    if (conflict >= 0) {
+      conflicts++;
+      untilRestart--;
+      if (decisionLevel() == 0) {
+        ok = false;
+        result = Result::UNSAT;
+        break;
+      }
+      int backLevel;
+      analyze(conflict, learnt, backLevel);
+      backtrack(backLevel);
+      if (learnt.size() == 1) {
+        enqueue(learnt[0], -1);
+      } else {
+        clauses.push_back({learnt, true});
+        attach((int)clauses.size() - 1);
+        enqueue(learnt[0], (int)clauses.size() - 1);
+      }
+      varInc /= 0.95;
+      continue;
+    }
+
+    if ((budgetEnd >= 0 && conflicts >= budgetEnd) ||
+        (cancel && cancel->load(std::memory_order_relaxed)))
+      break;
+    if (untilRestart <= 0) {
+      untilRestart = 100 * luby(++restart);
+      backtrack(0);
+      continue;
+    }
+
+    int next = -1;
+    bool failed = false;
+    while (decisionLevel() < (int)assume.size()) {
+      int a = assume[decisionLevel()];
+      if (value(a) == 1) {
+        trailLim.push_back((int)trail.size());
+      } else if (value(a) == 0) {
+        failed = true;
+        break;
+      } else {
+        next = a;
+        break;
+      }
+    }
+    if (failed) {
+      result = Result::UNSAT;
+      break;
+    }
+    if (next < 0) {
+      next = pickBranch();
+      if (next < 0) {
+        model = assigns;
+        result = Result::SAT;
+        break;
+      }
+      decisions++;
+    }
+    trailLim.push_back((int)trail.size());
+    enqueue(next, -1);
+  }
+
+  backtrack(0);
+  return result;
+}
@@ -0,0 +1,176 @@
+#include "../include/satBackend.hpp"
+#include "../include/sat.hpp"
+
+static const int kDir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+                               {0, 1},   {1, -1}, {1, 0},  {1, 1}};
+
+// Every (k + 1)-subset has a false literal. Only used for the <= 8 cells
+// around a number, where the direct encoding beats a counter.
+static void atMostDirect(SatSolver &sat, const std::vector<int> &xs, int k) {
+  int n = (int)xs.size();
+  if (k >= n)
+    return;
+  std::vector<int> pick(k + 1);
+  for (int i = 0; i <= k; ++i)
+    pick[i] = i;
+  for (;;) {
+    std::vector<int> clause;
+    for (int i : pick)
+      clause.push_back(-xs[i]);
+    sat.addClause(clause);
+
+    int i = k;
+    while (i >= 0 && pick[i] == n - k - 1 + i)
+      i--;
+    if (i < 0)
+      break;
+    pick[i]++;
+    for (int j = i + 1; j <= k; ++j)
+      pick[j] = pick[j - 1] + 1;
+  }
+}
+
+// Sinz sequential counter: s[i][j] means at least j + 1 of xs[0..i] are true.
+static void atMostCounter(SatSolver &sat, const std::vector<int> &xs, int k) {
+  int n = (int)xs.size();
+  if (k >= n)
+    return;
+  if (k <= 0) {
+    for (int x : xs)
+      sat.addClause({-x});
+    return;
+  }
+
+  std::vector<std::vector<int>> s(n - 1, std::vector<int>(k));
+  for (auto &row : s)
+    for (int &v : row)
+      v = sat.newVar();
+
+  sat.addClause({-xs[0], s[0][0]});
+  for (int j = 1; j < k; ++j)
+    sat.addClause({-s[0][j]});
+  for (int i = 1; i < n - 1; ++i) {
+    sat.addClause({-xs[i], s[i][0]});
+    sat.addClause({-s[i - 1][0], s[i][0]});
+    for (int j = 1; j < k; ++j) {
+      sat.addClause({-xs[i], -s[i - 1][j - 1], s[i][j]});
+      sat.addClause({-s[i - 1][j], s[i][j]});
+    }
+    sat.addClause({-xs[i], -s[i - 1][k - 1]});
+  }
+  sat.addClause({-xs[n - 1], -s[n - 2][k - 1]});
+}
+
+static std::vector<int> negated(const std::vector<int> &xs) {
+  std::vector<int> out;
+  for (int x : xs)
+    out.push_back(-x);
+  return out;
+}
+
+bool SatBackend::findForced(const BoardView &view,
+                            const std::vector<int> &query, SatForced &out,
+                            long conflictBudget,
+                            const std::atomic<bool> *cancel) {
+  out = SatForced();
+  int n = view.rows * view.cols;
+
+  SatSolver sat;
+  std::vector<int> var(n, 0);
+  std::vector<int> frontier;
+  int flags = 0, unknown = 0;
+  for (int i = 0; i < n; ++i) {
+    if (view.cells[i] == CELL_FLAGGED)
+      flags++;
+    else if (view.cells[i] == CELL_UNKNOWN)
+      unknown++;
+  }
+
+  for (int i = 0; i < n; ++i) {
+    if (view.cells[i] < 0)
+      continue;
+    int need = view.cells[i];
+    std::vector<int> xs;
+    int r = i / view.cols, c = i % view.cols;
+    for (auto &d : kDir) {
+      int nr = r + d[0], nc = c + d[1];
+      if (nr < 0 || nr >= view.rows || nc < 0 || nc >= view.cols)
+        continue;
+      int ni = nr * view.cols + nc;
+      if (view.cells[ni] == CELL_FLAGGED) {
+        need--;
+      } else if (view.cells[ni] == CELL_UNKNOWN) {
+        if (var[ni] == 0) {
+          var[ni] = sat.newVar();
+          frontier.push_back(ni);
+        }
+        xs.push_back(var[ni]);
+      }
+    }
+    if (need < 0 || need > (int)xs.size()) {
+      out.consistent = false;
+      return true;
+    }
+    atMostDirect(sat, xs, need);
+    atMostDirect(sat, negated(xs), (int)xs.size() - need);
+  }
+
+  int remaining = view.mines - flags;
+  int interior = unknown - (int)frontier.size();
+  std::vector<int> all;
+  for (int cell : frontier)
+    all.push_back(var[cell]);
+  if (view.mines >= 0) {
+    if (remaining < 0 || remaining - interior > (int)frontier.size()) {
+      out.consistent = false;
+      return true;
+    }
+    atMostCounter(sat, all, remaining);
+    atMostCounter(sat, negated(all),
+                  (int)all.size() - (remaining - interior));
+  }
+
+  std::vector<int> cells;
+  for (int cell : (query.empty() ? frontier : query))
+    if (cell >= 0 && cell < n && var[cell] != 0)
+      cells.push_back(cell);
+
+  SatSolver::Result res = sat.solve({}, conflictBudget, cancel);
+  if (res == SatSolver::Result::UNSAT) {
+    out.consistent = false;
+    out.conflicts = sat.getConflicts();
+    return true;
+  }
+  if (res == SatSolver::Result::UNKNOWN) {
+    out.complete = false;
+    out.conflicts = sat.getConflicts();
+    return !(cancel && cancel->load());
+  }
+
+  // A cell is forced unless some model disagrees with the first one on it;
+  // every new model rules out all the cells it flips at once.
+  std::vector<bool> first(cells.size()), flexible(cells.size(), false);
+  for (size_t i = 0; i < cells.size(); ++i)
+    first[i] = sat.modelValue(var[cells[i]]);
+
+  for (size_t i = 0; i < cells.size(); ++i) {
+    if (flexible[i])
+      continue;
+    int v = var[cells[i]];
+    res = sat.solve({first[i] ? -v : v}, conflictBudget, cancel);
+    if (res == SatSolver::Result::UNSAT) {
+      sat.addClause({first[i] ? v : -v});
+      (first[i] ? out.mineCells : out.safeCells).push_back(cells[i]);
+    } else if (res == SatSolver::Result::SAT) {
+      for (size_t j = i; j < cells.size(); ++j)
+        if (sat.modelValue(var[cells[j]]) != first[j])
+          flexible[j] = true;
+    } else {
+      if (cancel && cancel->load())
+        return false;
+      out.complete = false;
+    }
+  }
+  out.conflicts = sat.getConflicts();
+  return true;
+}
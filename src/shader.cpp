@@ -1,4 +1,6 @@
 #include "../include/shader.hpp"
+#include "../include/glState.hpp"
+#include "../include/projection.hpp"
 #include <iostream>
 
 const char *vertexShaderSource = R"(
@@ -7,7 +9,9 @@ const char *vertexShaderSource = R"(
     layout (location = 1) in vec2 aTexCoord;
 
     out vec2 TexCoord;
-    uniform mat4 projection;
+    layout (std140) uniform Projection {
+        mat4 projection;
+    };
 
     void main() {
         gl_Position = projection * vec4(aPos, 0.0, 1.0);
@@ -27,6 +31,51 @@ const char *fragmentShaderSource = R"(
     }
 )";
 
+const char *gridVertexShaderSource = R"(
+    #version 330 core
+    layout (location = 0) in vec2 aCorner;
+
+    out vec2 Local;
+    layout (std140) uniform Projection {
+        mat4 projection;
+    };
+    uniform vec4 rect;
+    uniform vec2 gridSize;
+
+    void main() {
+        vec2 pos = rect.xy + aCorner * rect.zw;
+        gl_Position = projection * vec4(pos, 0.0, 1.0);
+        Local = aCorner * gridSize;
+    }
+)";
+
+// Local is in cells; each texel of cells is a TileSprite in the low 5 bits
+// and a tint slot above. Gradients come from the unwrapped coordinate so mip
+// selection does not jump at cell edges.
+const char *gridFragmentShaderSource = R"(
+    #version 330 core
+    in vec2 Local;
+    out vec4 FragColor;
+
+    uniform usampler2D cells;
+    uniform sampler2DArray sprites;
+    uniform vec4 tints[3];
+    uniform int hoverCell;
+
+    void main() {
+    ivec2 size = textureSize(cells, 0);
+    ivec2 cell = clamp(ivec2(floor(Local)), ivec2(0), size - 1);
+    uint v = texelFetch(cells, cell, 0).r;
+    uint sprite = v & 31u;
+    if (cell.y * size.x + cell.x == hoverCell && sprite == 0u)
+        sprite = 1u;
+    vec4 c = textureGrad(sprites, vec3(fract(Local), float(sprite)),
+                         dFdx(Local), dFdy(Local));
+    vec4 t = tints[min(v >> 5, 2u)];
+    FragColor = vec4(mix(c.rgb, t.rgb, t.a), c.a);
+    }
+)";
+
 GLuint Shader::compile(GLenum type, const char *src) {
   GLuint s = glCreateShader(type);
   glShaderSource(s, 1, &src, nullptr);
@@ -42,13 +91,23 @@ GLuint Shader::compile(GLenum type, const char *src) {
 }
 
 GLuint Shader::createProgram() {
-  GLuint v = compile(GL_VERTEX_SHADER, vertexShaderSource);
-  GLuint f = compile(GL_FRAGMENT_SHADER, fragmentShaderSource);
+  return link(vertexShaderSource, fragmentShaderSource);
+}
+
+GLuint Shader::createGridProgram() {
+  return link(gridVertexShaderSource, gridFragmentShaderSource);
+}
+
+GLuint Shader::link(const char *vertexSrc, const char *fragmentSrc) {
+  GLuint v = compile(GL_VERTEX_SHADER, vertexSrc);
+  GLuint f = compile(GL_FRAGMENT_SHADER, fragmentSrc);
   GLuint p = glCreateProgram();
   glAttachShader(p, v);
   glAttachShader(p, f);
   glLinkProgram(p);
   glDeleteShader(v);
   glDeleteShader(f);
+  glState.cacheUniforms(p);
+  ProjectionBuffer::attach(p);
   return p;
 }
@@ -0,0 +1,228 @@
+#include "../include/sharedBoard.hpp"
+#include "../include/clock.hpp"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <new>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+static SharedSegment *mapSegment(int fd, size_t bytes) {
+  void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  return p == MAP_FAILED ? nullptr : static_cast<SharedSegment *>(p);
+}
+
+bool SharedBoardHost::open(const std::string &n, int maxCells) {
+  close();
+  int fd = shm_open(n.c_str(), O_CREAT | O_RDWR, 0600);
+  if (fd < 0) {
+    std::cerr << "shm_open failed for " << n << std::endl;
+    return false;
+  }
+  bytes = SharedSegment::bytesFor(maxCells);
+  if (ftruncate(fd, (off_t)bytes) != 0) {
+    std::cerr << "ftruncate failed for " << n << std::endl;
+    ::close(fd);
+    shm_unlink(n.c_str());
+    return false;
+  }
+  seg = mapSegment(fd, bytes);
+  ::close(fd);
+  if (!seg) {
+    std::cerr << "mmap failed for " << n << std::endl;
+    shm_unlink(n.c_str());
+    return false;
+  }
+
+  name = n;
+  new (seg) SharedSegment();
+  seg->maxCells = (uint32_t)maxCells;
+  seg->seq.store(0, std::memory_order_relaxed);
+  seg->head.store(0, std::memory_order_relaxed);
+  seg->tail.store(0, std::memory_order_relaxed);
+  seg->version = SharedSegment::kVersion;
+  std::atomic_thread_fence(std::memory_order_release);
+  seg->magic = SharedSegment::kMagic;
+  return true;
+}
+
+void SharedBoardHost::close() {
+  if (!seg)
+    return;
+  munmap(seg, bytes);
+  shm_unlink(name.c_str());
+  seg = nullptr;
+}
+
+// Widened before multiplying: two uint16_t promote to int, and 65535^2
+// overflows it.
+bool SharedBoardHost::fits(const SharedCommand &cmd) const {
+  return seg && cmd.rows > 0 && cmd.cols > 0 &&
+         (uint32_t)cmd.rows * cmd.cols <= seg->maxCells;
+}
+
+void SharedBoardHost::publish(const Board &board, double elapsed) {
+  if (!seg || board.size() > (int)seg->maxCells)
+    return;
+  uint32_t s = seg->seq.load(std::memory_order_relaxed);
+  seg->seq.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  seg->rows = (uint32_t)board.getRows();
+  seg->cols = (uint32_t)board.getCols();
+  seg->mines = (uint32_t)board.getMineCount();
+  seg->state = (uint32_t)board.getState();
+  seg->frame = ++frame;
+  seg->elapsed = elapsed;
+  uint8_t *cells = seg->cells();
+  for (int i = 0; i < board.size(); ++i)
+    cells[i] = board.code(i);
+
+  seg->seq.store(s + 2, std::memory_order_release);
+}
+
+bool SharedBoardHost::poll(SharedCommand &cmd) {
+  if (!seg)
+    return false;
+  uint32_t tail = seg->tail.load(std::memory_order_relaxed);
+  if (tail == seg->head.load(std::memory_order_acquire))
+    return false;
+  cmd = seg->ring[tail % SharedSegment::kRingSize];
+  seg->tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+bool SharedBoardClient::attach(const std::string &name) {
+  detach();
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0)
+    return false;
+  // magic, version, maxCells
+  uint32_t header[3];
+  if (pread(fd, header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+      header[0] != SharedSegment::kMagic ||
+      header[1] != SharedSegment::kVersion) {
+    ::close(fd);
+    return false;
+  }
+  bytes = SharedSegment::bytesFor((int)header[2]);
+  seg = mapSegment(fd, bytes);
+  ::close(fd);
+  return seg != nullptr;
+}
+
+void SharedBoardClient::detach() {
+  if (seg)
+    munmap(seg, bytes);
+  seg = nullptr;
+}
+
+bool SharedBoardClient::read(SharedSnapshot &out) const {
+  if (!seg)
+    return false;
+  for (;;) {
+    uint32_t s1 = seg->seq.load(std::memory_order_acquire);
+    if (s1 == 0)
+      return false;
+    if (s1 & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    out.rows = (int)seg->rows;
+    out.cols = (int)seg->cols;
+    out.mines = (int)seg->mines;
+    out.state = (GameState)seg->state;
+    out.frame = seg->frame;
+    out.elapsed = seg->elapsed;
+    size_t n = (size_t)out.rows * out.cols;
+    if (n > seg->maxCells)
+      n = 0;
+    out.cells.resize(n);
+    std::memcpy(out.cells.data(), seg->cells(), n);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seg->seq.load(std::memory_order_relaxed) == s1)
+      return true;
+  }
+}
+
+uint32_t SharedBoardClient::sequence() const {
+  return seg ? seg->seq.load(std::memory_order_acquire) : 0;
+}
+
+bool SharedBoardClient::submit(const SharedCommand &cmd) {
+  if (!seg)
+    return false;
+  uint32_t head = seg->head.load(std::memory_order_relaxed);
+  if (head - seg->tail.load(std::memory_order_acquire) >=
+      SharedSegment::kRingSize)
+    return false;
+  seg->ring[head % SharedSegment::kRingSize] = cmd;
+  seg->head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+// Headless time is virtual: each command on a game in progress is one tick,
+// so elapsed times are the same on every run however fast the bot plays.
+// As in the game, the timer starts at the first reveal and stops at the
+// end.
+int serveShared(const std::string &name) {
+  const int maxCells = 1 << 20;
+  SharedBoardHost host;
+  if (!host.open(name, maxCells))
+    return 1;
+
+  Board board;
+  board.reset(9, 9, 10, 0);
+  VirtualClock clock;
+  bool timing = false;
+  double startTime = 0.0, elapsed = 0.0;
+  host.publish(board, elapsed);
+  auto idle = std::chrono::microseconds(50);
+  for (;;) {
+    SharedCommand cmd;
+    bool changed = false;
+    while (host.poll(cmd)) {
+      bool inBoard = cmd.cell < (uint32_t)board.size();
+      bool playing = board.getState() == GameState::PLAYING;
+      if (playing && cmd.op != SHM_NEW && cmd.op != SHM_QUIT)
+        clock.tick();
+      if (playing && inBoard && !timing &&
+          (cmd.op == SHM_REVEAL || cmd.op == SHM_CHORD)) {
+        timing = true;
+        startTime = clock.now();
+      }
+      switch (cmd.op) {
+      case SHM_NEW:
+        if (host.fits(cmd)) {
+          board.reset(cmd.rows, cmd.cols, cmd.mines, cmd.seed);
+          timing = false;
+          elapsed = 0.0;
+        }
+        break;
+      case SHM_REVEAL:
+        if (inBoard)
+          board.reveal((int)cmd.cell);
+        break;
+      case SHM_FLAG:
+        if (inBoard)
+          board.toggleFlag((int)cmd.cell);
+        break;
+      case SHM_CHORD:
+        if (inBoard)
+          board.chord((int)cmd.cell);
+        break;
+      case SHM_QUIT:
+        return 0;
+      }
+      if (timing && playing)
+        elapsed = clock.now() - startTime;
+      changed = true;
+    }
+    if (changed)
+      host.publish(board, elapsed);
+    else
+      std::this_thread::sleep_for(idle);
+  }
+}
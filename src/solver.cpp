@@ -0,0 +1,388 @@
+#include "../include/solver.hpp"
+#include "../include/satBackend.hpp"
+#include <cmath>
+#include <limits>
+#include <map>
+
+static const int kDir[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+                               {0, 1},   {1, -1}, {1, 0},  {1, 1}};
+
+static double logChoose(int n, int k) {
+  if (k < 0 || k > n)
+    return -std::numeric_limits<double>::infinity();
+  return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) -
+         std::lgamma(n - k + 1.0);
+}
+
+static std::vector<double> convolve(const std::vector<double> &a,
+                                    const std::vector<double> &b) {
+  std::vector<double> out(a.size() + b.size() - 1, 0.0);
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i] == 0.0)
+      continue;
+    for (size_t j = 0; j < b.size(); ++j)
+      out[i + j] += a[i] * b[j];
+  }
+  return out;
+}
+
+static int findRoot(std::vector<int> &parent, int i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+Solver::Solver(long maxNodes) : maxNodes(maxNodes) {}
+
+void Solver::clearCache() { cache.clear(); }
+
+void Solver::setSampleOptions(const SampleOptions &opts) { sampling = opts; }
+
+void Solver::setSatConflictBudget(long budget) { satConflictBudget = budget; }
+
+bool Solver::enumerate(Component &comp, const std::atomic<bool> *cancel) {
+  int m = (int)comp.cells.size();
+  int nc = (int)comp.constraints.size();
+
+  std::vector<std::vector<int>> cellCons(m);
+  std::vector<int> need(nc), sum(nc, 0), left(nc);
+  for (int i = 0; i < m; ++i)
+    localIndex[comp.cells[i]] = i;
+  for (int j = 0; j < nc; ++j) {
+    const Constraint &c = constraints[comp.constraints[j]];
+    need[j] = c.need;
+    left[j] = (int)c.cells.size();
+    for (int cell : c.cells)
+      cellCons[localIndex[cell]].push_back(j);
+  }
+
+  comp.counts.assign(m + 1, 0.0);
+  comp.cellCounts.assign(m, std::vector<double>(m + 1, 0.0));
+  comp.exact = false;
+
+  std::vector<int> val(m, -1);
+  long nodes = 0;
+  int pos = 0;
+  while (pos >= 0) {
+    if (pos == m) {
+      int k = 0;
+      for (int i = 0; i < m; ++i)
+        k += val[i];
+      comp.counts[k] += 1.0;
+      for (int i = 0; i < m; ++i)
+        if (val[i])
+          comp.cellCounts[i][k] += 1.0;
+      pos--;
+      continue;
+    }
+
+    if (val[pos] >= 0) {
+      for (int j : cellCons[pos]) {
+        sum[j] -= val[pos];
+        left[j]++;
+      }
+    }
+    if (++val[pos] > 1) {
+      val[pos] = -1;
+      pos--;
+      continue;
+    }
+
+    if (++nodes > maxNodes)
+      return true;
+    if ((nodes & 4095) == 0 && cancel &&
+        cancel->load(std::memory_order_relaxed))
+      return false;
+
+    bool ok = true;
+    for (int j : cellCons[pos]) {
+      sum[j] += val[pos];
+      left[j]--;
+      if (sum[j] > need[j] || sum[j] + left[j] < need[j])
+        ok = false;
+    }
+    if (ok)
+      pos++;
+  }
+
+  comp.exact = true;
+  return true;
+}
+
+bool Solver::solve(const BoardView &view, SolveResult &out,
+                   const std::atomic<bool> *cancel) {
+  int n = view.rows * view.cols;
+  out.mineProbability.assign(n, -1.0f);
+  out.safeCells.clear();
+  out.mineCells.clear();
+  out.bestGuess = -1;
+  out.logWeight = 0.0;
+  out.consistent = true;
+
+  constraints.clear();
+  localIndex.assign(n, -1);
+  int flags = 0;
+  int unknown = 0;
+  for (int i = 0; i < n; ++i) {
+    if (view.cells[i] == CELL_FLAGGED)
+      flags++;
+    else if (view.cells[i] == CELL_UNKNOWN)
+      unknown++;
+  }
+
+  std::vector<int> parent(n);
+  for (int i = 0; i < n; ++i)
+    parent[i] = i;
+
+  for (int i = 0; i < n; ++i) {
+    int v = view.cells[i];
+    if (v < 0)
+      continue;
+    Constraint c;
+    c.need = v;
+    int r = i / view.cols;
+    int col = i % view.cols;
+    for (auto &d : kDir) {
+      int nr = r + d[0];
+      int ncol = col + d[1];
+      if (nr < 0 || nr >= view.rows || ncol < 0 || ncol >= view.cols)
+        continue;
+      int ni = nr * view.cols + ncol;
+      if (view.cells[ni] == CELL_UNKNOWN)
+        c.cells.push_back(ni);
+      else if (view.cells[ni] == CELL_FLAGGED)
+        c.need--;
+    }
+    if (c.need < 0 || c.need > (int)c.cells.size())
+      out.consistent = false;
+    if (c.cells.empty())
+      continue;
+    for (size_t k = 1; k < c.cells.size(); ++k) {
+      int a = findRoot(parent, c.cells[0]);
+      int b = findRoot(parent, c.cells[k]);
+      if (a != b)
+        parent[b] = a;
+    }
+    constraints.push_back(c);
+  }
+
+  std::vector<Component> comps;
+  std::vector<int> compOf(n, -1);
+  std::vector<bool> onFrontier(n, false);
+  for (size_t j = 0; j < constraints.size(); ++j) {
+    int root = findRoot(parent, constraints[j].cells[0]);
+    if (compOf[root] < 0) {
+      compOf[root] = (int)comps.size();
+      comps.emplace_back();
+    }
+    Component &comp = comps[compOf[root]];
+    comp.constraints.push_back((int)j);
+    for (int cell : constraints[j].cells) {
+      if (!onFrontier[cell]) {
+        onFrontier[cell] = true;
+        comp.cells.push_back(cell);
+      }
+    }
+  }
+
+  // A move only changes the constraints of the components it touches, so the
+  // rest are looked up by their constraint signature instead of re-enumerated.
+  std::map<std::vector<int>, Component> used;
+  out.componentsSolved = 0;
+  out.componentsReused = 0;
+  for (auto &comp : comps) {
+    std::vector<int> key;
+    for (int j : comp.constraints) {
+      key.push_back(constraints[j].need);
+      key.push_back((int)constraints[j].cells.size());
+      key.insert(key.end(), constraints[j].cells.begin(),
+                 constraints[j].cells.end());
+    }
+    auto hit = cache.find(key);
+    if (hit != cache.end()) {
+      comp.exact = hit->second.exact;
+      comp.counts = hit->second.counts;
+      comp.cellCounts = hit->second.cellCounts;
+      out.componentsReused++;
+    } else {
+      if (!enumerate(comp, cancel))
+        return false;
+      out.componentsSolved++;
+    }
+    used.emplace(std::move(key), comp);
+  }
+  cache.swap(used);
+
+  // Local density estimate for cells the exact pass cannot cover.
+  int remaining = view.mines - flags;
+  if (remaining < 0) {
+    remaining = 0;
+    out.consistent = false;
+  }
+  auto localEstimate = [&](int cell) {
+    float p = 0.0f;
+    int seen = 0;
+    for (auto &c : constraints) {
+      for (int x : c.cells) {
+        if (x == cell) {
+          p += (float)c.need / (float)c.cells.size();
+          seen++;
+          break;
+        }
+      }
+    }
+    if (seen == 0)
+      return unknown > 0 ? (float)remaining / (float)unknown : 0.0f;
+    return p / (float)seen;
+  };
+
+  std::vector<int> exactComps;
+  int loose = 0;
+  for (int i = 0; i < (int)comps.size(); ++i) {
+    if (comps[i].exact)
+      exactComps.push_back(i);
+    else
+      loose += (int)comps[i].cells.size();
+  }
+  int interior = 0;
+  for (int i = 0; i < n; ++i)
+    if (view.cells[i] == CELL_UNKNOWN && !onFrontier[i])
+      interior++;
+  int pool = interior + loose;
+
+  int m = (int)exactComps.size();
+  std::vector<std::vector<double>> pre(m + 1), suf(m + 1);
+  pre[0] = {1.0};
+  for (int i = 0; i < m; ++i)
+    pre[i + 1] = convolve(pre[i], comps[exactComps[i]].counts);
+  suf[m] = {1.0};
+  for (int i = m - 1; i >= 0; --i)
+    suf[i] = convolve(comps[exactComps[i]].counts, suf[i + 1]);
+
+  const std::vector<double> &total = pre[m];
+  int maxS = (int)total.size() - 1;
+  std::vector<double> logB(maxS + 1);
+  double maxLog = -std::numeric_limits<double>::infinity();
+  for (int s = 0; s <= maxS; ++s) {
+    logB[s] = logChoose(pool, remaining - s);
+    if (total[s] > 0.0 && logB[s] > maxLog)
+      maxLog = logB[s];
+  }
+  std::vector<double> b(maxS + 1, 0.0);
+  double weight = 0.0;
+  if (std::isfinite(maxLog)) {
+    for (int s = 0; s <= maxS; ++s) {
+      if (std::isfinite(logB[s]))
+        b[s] = std::exp(logB[s] - maxLog);
+      weight += total[s] * b[s];
+    }
+  }
+
+  if (weight <= 0.0 || !out.consistent) {
+    out.consistent = false;
+    for (int i = 0; i < n; ++i)
+      if (view.cells[i] == CELL_UNKNOWN)
+        out.mineProbability[i] = localEstimate(i);
+  } else {
+    out.logWeight = std::log(weight) + maxLog;
+
+    for (int i = 0; i < m; ++i) {
+      const Component &comp = comps[exactComps[i]];
+      std::vector<double> other = convolve(pre[i], suf[i + 1]);
+      int kMax = (int)comp.counts.size() - 1;
+      std::vector<double> g(kMax + 1, 0.0);
+      for (int k = 0; k <= kMax; ++k)
+        for (size_t s = 0; s < other.size() && k + (int)s <= maxS; ++s)
+          g[k] += other[s] * b[k + s];
+
+      for (size_t c = 0; c < comp.cells.size(); ++c) {
+        double mine = 0.0, safe = 0.0;
+        for (int k = 0; k <= kMax; ++k) {
+          mine += comp.cellCounts[c][k] * g[k];
+          safe += (comp.counts[k] - comp.cellCounts[c][k]) * g[k];
+        }
+        int cell = comp.cells[c];
+        out.mineProbability[cell] = (float)(mine / weight);
+        if (mine == 0.0)
+          out.safeCells.push_back(cell);
+        else if (safe == 0.0)
+          out.mineCells.push_back(cell);
+      }
+    }
+
+    double mineSum = 0.0, safeSum = 0.0;
+    for (int s = 0; s <= maxS; ++s) {
+      mineSum += total[s] * b[s] * (remaining - s);
+      safeSum += total[s] * b[s] * (pool - (remaining - s));
+    }
+    float pInterior = pool > 0 ? (float)(mineSum / weight / pool) : 0.0f;
+    for (int i = 0; i < n; ++i) {
+      if (view.cells[i] != CELL_UNKNOWN || onFrontier[i])
+        continue;
+      out.mineProbability[i] = pInterior;
+      if (mineSum == 0.0)
+        out.safeCells.push_back(i);
+      else if (safeSum == 0.0)
+        out.mineCells.push_back(i);
+    }
+    bool hasInexact = false;
+    for (auto &comp : comps) {
+      if (comp.exact)
+        continue;
+      hasInexact = true;
+      for (int cell : comp.cells)
+        out.mineProbability[cell] = localEstimate(cell);
+    }
+
+    SampleResult sample;
+    out.sampled = false;
+    if (hasInexact && sampling.deadlineMs > 0.0) {
+      if (Sampler::estimate(view, sampling, sample, cancel)) {
+        out.sampled = true;
+        for (auto &comp : comps)
+          if (!comp.exact)
+            for (int cell : comp.cells)
+              out.mineProbability[cell] = sample.mineProbability[cell];
+      } else if (cancel && cancel->load()) {
+        return false;
+      }
+    }
+
+    // Sampling only estimates; a cell the sampler never saw as a mine may
+    // still be one. Decide the forced cells of those components exactly.
+    if (hasInexact && satConflictBudget != 0) {
+      std::vector<int> query;
+      for (auto &comp : comps)
+        if (!comp.exact)
+          query.insert(query.end(), comp.cells.begin(), comp.cells.end());
+      SatForced forced;
+      if (!SatBackend::findForced(view, query, forced, satConflictBudget,
+                                  cancel))
+        return false;
+      for (int cell : forced.safeCells) {
+        out.mineProbability[cell] = 0.0f;
+        out.safeCells.push_back(cell);
+      }
+      for (int cell : forced.mineCells) {
+        out.mineProbability[cell] = 1.0f;
+        out.mineCells.push_back(cell);
+      }
+    }
+  }
+
+  if (!out.safeCells.empty()) {
+    out.bestGuess = out.safeCells.front();
+  } else {
+    float best = 2.0f;
+    for (int i = 0; i < n; ++i) {
+      float p = out.mineProbability[i];
+      if (view.cells[i] == CELL_UNKNOWN && p < best) {
+        best = p;
+        out.bestGuess = i;
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,64 @@
+#include "../include/solverWorker.hpp"
+
+SolverWorker::SolverWorker(long maxNodes) : solver(maxNodes), cancel(false) {}
+
+SolverWorker::~SolverWorker() { stop(); }
+
+void SolverWorker::start() {
+  if (thread.joinable())
+    return;
+  stopping = false;
+  thread = std::thread(&SolverWorker::run, this);
+}
+
+void SolverWorker::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+    cancel.store(true);
+  }
+  cv.notify_one();
+  if (thread.joinable())
+    thread.join();
+}
+
+void SolverWorker::submit(const BoardView &view, uint64_t version) {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    pending = view;
+    pendingVersion = version;
+    hasPending = true;
+    cancel.store(true);
+  }
+  cv.notify_one();
+}
+
+std::shared_ptr<const SolveResult> SolverWorker::latest() const {
+  return std::atomic_load(&published);
+}
+
+void SolverWorker::run() {
+  BoardView view;
+  uint64_t version = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv.wait(lock, [this] { return hasPending || stopping; });
+      if (stopping)
+        return;
+      std::swap(view, pending);
+      version = pendingVersion;
+      hasPending = false;
+      cancel.store(false);
+    }
+
+    auto result = std::make_shared<SolveResult>();
+    if (!solver.solve(view, *result, &cancel))
+      continue;
+    result->version = version;
+    std::atomic_store(&published,
+                      std::shared_ptr<const SolveResult>(std::move(result)));
+    if (onPublish)
+      onPublish();
+  }
+}
@@ -0,0 +1,88 @@
+#include "../include/spriteBatch.hpp"
+#include "../include/glState.hpp"
+#include <algorithm>
+
+SpriteBatch::~SpriteBatch() {
+  glState.deleteVertexArray(vao);
+  glDeleteBuffers(1, &ebo);
+}
+
+void SpriteBatch::init(bool persistentStream) {
+  glGenVertexArrays(1, &vao);
+  glGenBuffers(1, &ebo);
+  stream.init(64 * 1024, persistentStream);
+
+  glState.bindVertexArray(vao);
+  glEnableVertexAttribArray(0);
+  glEnableVertexAttribArray(1);
+
+  reserve(64);
+}
+
+// Grows the index buffer, which never changes for a given quad count.
+void SpriteBatch::reserve(size_t quadCount) {
+  if (quadCount <= capacity)
+    return;
+  capacity = std::max(quadCount, capacity * 2);
+
+  std::vector<unsigned int> indices(capacity * 6);
+  for (size_t q = 0; q < capacity; ++q) {
+    unsigned int base = (unsigned int)(q * 4);
+    unsigned int quad[] = {base, base + 1, base + 2, base + 2, base + 3, base};
+    std::copy(quad, quad + 6, indices.begin() + q * 6);
+  }
+  glState.bindVertexArray(vao);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+               indices.data(), GL_STATIC_DRAW);
+}
+
+void SpriteBatch::add(GLuint prog, float x, float y, float w, float h,
+                      GLuint tex, float u0, float v0, float u1, float v1) {
+  if (prog != program) {
+    flush();
+    program = prog;
+  }
+  quads.push_back({tex, x, y, w, h, u0, v0, u1, v1});
+}
+
+void SpriteBatch::flush() {
+  if (quads.empty())
+    return;
+  std::stable_sort(quads.begin(), quads.end(),
+                   [](const Quad &a, const Quad &b) { return a.tex < b.tex; });
+  reserve(quads.size());
+
+  vertices.clear();
+  for (const Quad &q : quads) {
+    float x1 = q.x + q.w, y1 = q.y + q.h;
+    vertices.insert(vertices.end(),
+                    {q.x, q.y, q.u0, q.v0, x1, q.y, q.u1, q.v0, x1, y1, q.u1,
+                     q.v1, q.x, y1, q.u0, q.v1});
+  }
+
+  glState.useProgram(program);
+  glUniform1i(glState.uniform(program, "tex"), 0);
+  glState.bindVertexArray(vao);
+
+  size_t stride = 4 * sizeof(float);
+  size_t offset = stream.write(vertices.data(),
+                               vertices.size() * sizeof(float), stride);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, (GLsizei)stride,
+                        (void *)offset);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, (GLsizei)stride,
+                        (void *)(offset + 2 * sizeof(float)));
+
+  size_t start = 0;
+  while (start < quads.size()) {
+    size_t end = start + 1;
+    while (end < quads.size() && quads[end].tex == quads[start].tex)
+      end++;
+    glState.bindTexture(GL_TEXTURE_2D, quads[start].tex);
+    glDrawElements(GL_TRIANGLES, (GLsizei)((end - start) * 6),
+                   GL_UNSIGNED_INT,
+                   (void *)(start * 6 * sizeof(unsigned int)));
+    start = end;
+  }
+  quads.clear();
+}
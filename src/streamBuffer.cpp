@@ -0,0 +1,131 @@
+#include "../include/streamBuffer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+static double nowSeconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+StreamBuffer::~StreamBuffer() { release(); }
+
+// Buffer storage is core in 4.4, and the loader only carries core
+// entry points, so the version flag stands in for the extension.
+void StreamBuffer::init(size_t regionBytes, bool allowPersistent) {
+  persistent = allowPersistent && GLAD_GL_VERSION_4_4 && glBufferStorage;
+  allocate(regionBytes);
+}
+
+void StreamBuffer::release() {
+  for (GLsync &f : fences) {
+    if (f)
+      glDeleteSync(f);
+    f = nullptr;
+  }
+  if (!buffer)
+    return;
+  if (mapped) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    mapped = nullptr;
+  }
+  glDeleteBuffers(1, &buffer);
+  buffer = 0;
+}
+
+// Deleting the old buffer is safe while draws still read it; GL keeps the
+// storage alive until they finish.
+void StreamBuffer::allocate(size_t regionBytes) {
+  release();
+  regionSize = regionBytes;
+  cursor = 0;
+  region = 0;
+  regionReady = true;
+
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  if (persistent) {
+    GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_ARRAY_BUFFER, regionSize * kRegions, nullptr, flags);
+    mapped = (unsigned char *)glMapBufferRange(
+        GL_ARRAY_BUFFER, 0, regionSize * kRegions, flags);
+    if (mapped)
+      return;
+    persistent = false;
+    glDeleteBuffers(1, &buffer);
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  }
+  glBufferData(GL_ARRAY_BUFFER, regionSize, nullptr, GL_STREAM_DRAW);
+}
+
+void StreamBuffer::waitRegion(int r) {
+  GLsync f = fences[r];
+  if (!f)
+    return;
+  double start = nowSeconds();
+  GLenum res = glClientWaitSync(f, 0, 0);
+  while (res == GL_TIMEOUT_EXPIRED)
+    res = glClientWaitSync(f, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+  stall += nowSeconds() - start;
+  glDeleteSync(f);
+  fences[r] = nullptr;
+}
+
+size_t StreamBuffer::write(const void *data, size_t bytes, size_t align) {
+  size_t offset = (cursor + align - 1) / align * align;
+  if (offset + bytes > regionSize) {
+    // Out of room for this frame: grow, or in the fallback just orphan.
+    if (persistent || bytes > regionSize)
+      allocate(std::max(regionSize * 2, bytes));
+    else {
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+      glBufferData(GL_ARRAY_BUFFER, regionSize, nullptr, GL_STREAM_DRAW);
+    }
+    offset = 0;
+  }
+  cursor = offset + bytes;
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+  if (persistent) {
+    if (!regionReady) {
+      waitRegion(region);
+      regionReady = true;
+    }
+    size_t at = (size_t)region * regionSize + offset;
+    std::memcpy(mapped + at, data, bytes);
+    return at;
+  }
+
+  // Nothing drawn this frame reads past the cursor, so the append needs no
+  // synchronization; the map time is what a stall would show up as.
+  double start = nowSeconds();
+  void *p = glMapBufferRange(GL_ARRAY_BUFFER, offset, bytes,
+                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                 GL_MAP_UNSYNCHRONIZED_BIT);
+  if (p) {
+    std::memcpy(p, data, bytes);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+  }
+  stall += nowSeconds() - start;
+  return offset;
+}
+
+void StreamBuffer::endFrame() {
+  if (persistent) {
+    if (fences[region])
+      glDeleteSync(fences[region]);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    region = (region + 1) % kRegions;
+    regionReady = false;
+  } else if (cursor > 0) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, regionSize, nullptr, GL_STREAM_DRAW);
+  }
+  cursor = 0;
+  lastStall = stall;
+  stall = 0.0;
+}
@@ -1,4 +1,6 @@
 #include "../include/textRenderer.hpp"
+#include "../include/glState.hpp"
+#include "../include/projection.hpp"
 #include <cstdio>
 #include <iostream>
 #include <vector>
@@ -6,7 +8,8 @@
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "../ext/stb_truetype.h"
 
-void TextRenderer::init(const char *filename, float pixelHeight) {
+void TextRenderer::init(const char *filename, float pixelHeight,
+                        bool persistentStream) {
   unsigned char *ttf_buffer = (unsigned char *)malloc(1 << 20);
   unsigned char *temp_bitmap = (unsigned char *)malloc(512 * 512);
   FILE *f = fopen(filename, "rb");
@@ -21,7 +24,7 @@ void TextRenderer::init(const char *filename, float pixelHeight) {
   free(ttf_buffer);
 
   glGenTextures(1, &texID);
-  glBindTexture(GL_TEXTURE_2D, texID);
+  glState.bindTexture(GL_TEXTURE_2D, texID);
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, 512, 512, 0, GL_RED, GL_UNSIGNED_BYTE,
                temp_bitmap);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -29,20 +32,15 @@ void TextRenderer::init(const char *filename, float pixelHeight) {
   free(temp_bitmap);
 
   glGenVertexArrays(1, &vao);
-  glGenBuffers(1, &vbo);
-  glBindVertexArray(vao);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4 * 128, NULL,
-               GL_DYNAMIC_DRAW);
+  glState.bindVertexArray(vao);
   glEnableVertexAttribArray(0);
-  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
   glEnableVertexAttribArray(1);
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
-                        (void *)(2 * sizeof(float)));
+  stream.init(sizeof(float) * 6 * 4 * 128, persistentStream);
 
   const char *vS = "#version 330 core\nlayout (location=0) in vec2 p; layout "
-                   "(location=1) in vec2 t; out vec2 T; uniform mat4 P; void "
-                   "main(){gl_Position=P*vec4(p,0,1); T=t;}";
+                   "(location=1) in vec2 t; out vec2 T; layout(std140) uniform "
+                   "Projection{mat4 P;}; void main(){gl_Position=P*vec4(p,0,1);"
+                   " T=t;}";
   const char *fS =
       "#version 330 core\nin vec2 T; out vec4 C; uniform sampler2D x; "
       "uniform vec3 c; void main(){C=vec4(c,texture(x,T).r);}";
@@ -58,6 +56,8 @@ void TextRenderer::init(const char *filename, float pixelHeight) {
   glLinkProgram(shaderProgram);
   glDeleteShader(vs);
   glDeleteShader(fs);
+  glState.cacheUniforms(shaderProgram);
+  ProjectionBuffer::attach(shaderProgram);
 }
 
 float TextRenderer::getWidth(const std::string &text, float scale) {
@@ -73,17 +73,11 @@ float TextRenderer::getWidth(const std::string &text, float scale) {
 }
 
 void TextRenderer::drawText(const std::string &text, float x, float y,
-                            float scale, float r, float g, float b, float sW,
-                            float sH) {
-  glUseProgram(shaderProgram);
-  float p[16] = {2.0f / sW, 0, 0,  0, 0,  -2.0f / sH, 0, 0,
-                 0,         0, -1, 0, -1, 1,          0, 1};
-  glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "P"), 1, GL_FALSE, p);
-  glUniform3f(glGetUniformLocation(shaderProgram, "c"), r, g, b);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, texID);
-  glBindVertexArray(vao);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+                            float scale, float r, float g, float b) {
+  glState.useProgram(shaderProgram);
+  glUniform3f(glState.uniform(shaderProgram, "c"), r, g, b);
+  glState.bindTexture(GL_TEXTURE_2D, texID);
+  glState.bindVertexArray(vao);
 
   std::vector<float> v;
 
@@ -106,6 +100,13 @@ void TextRenderer::drawText(const std::string &text, float x, float y,
              {x0, y1, q.s0, q.t1, x0, y0, q.s0, q.t0, x1, y0, q.s1, q.t0,
               x0, y1, q.s0, q.t1, x1, y0, q.s1, q.t0, x1, y1, q.s1, q.t1});
   }
-  glBufferSubData(GL_ARRAY_BUFFER, 0, v.size() * sizeof(float), v.data());
-  glDrawArrays(GL_TRIANGLES, 0, v.size() / 4);
+  if (v.empty())
+    return;
+  size_t stride = 4 * sizeof(float);
+  size_t offset = stream.write(v.data(), v.size() * sizeof(float), stride);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, (GLsizei)stride,
+                        (void *)offset);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, (GLsizei)stride,
+                        (void *)(offset + 2 * sizeof(float)));
+  glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(v.size() / 4));
 }
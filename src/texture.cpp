@@ -1,4 +1,5 @@
 #include "../include/texture.h"
+#include "../include/glState.hpp"
 #include <algorithm>
 #include <iostream>
 
@@ -23,7 +24,7 @@ static bool hasExtension(const std::string &path, const std::string &ext) {
 GLuint loadTexture(const std::string &path, int svgW, int svgH) {
   GLuint tex = 0;
   glGenTextures(1, &tex);
-  glBindTexture(GL_TEXTURE_2D, tex);
+  glState.bindTexture(GL_TEXTURE_2D, tex);
 
   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
@@ -85,3 +86,85 @@ GLuint loadTexture(const std::string &path, int svgW, int svgH) {
 
   return tex;
 }
+
+// Averages the source texels covered by each destination texel.
+static void boxResize(const unsigned char *src, int sw, int sh,
+                      unsigned char *dst, int dw, int dh) {
+  for (int y = 0; y < dh; ++y) {
+    int y0 = y * sh / dh, y1 = std::max(y0 + 1, (y + 1) * sh / dh);
+    for (int x = 0; x < dw; ++x) {
+      int x0 = x * sw / dw, x1 = std::max(x0 + 1, (x + 1) * sw / dw);
+      unsigned sum[4] = {0, 0, 0, 0};
+      for (int sy = y0; sy < y1; ++sy)
+        for (int sx = x0; sx < x1; ++sx)
+          for (int k = 0; k < 4; ++k)
+            sum[k] += src[(sy * sw + sx) * 4 + k];
+      unsigned count = (unsigned)((y1 - y0) * (x1 - x0));
+      for (int k = 0; k < 4; ++k)
+        dst[(y * dw + x) * 4 + k] = (unsigned char)(sum[k] / count);
+    }
+  }
+}
+
+bool loadImage(const std::string &path, int w, int h,
+               std::vector<unsigned char> &rgba, int &outW, int &outH) {
+  if (hasExtension(path, ".svg")) {
+    auto svg = lunasvg::Document::loadFromFile(path);
+    auto bmp = svg && w > 0 && h > 0 ? svg->renderToBitmap(w, h)
+                                     : lunasvg::Bitmap();
+    if (!bmp.valid()) {
+      std::cerr << "Failed to load SVG: " << path << std::endl;
+      return false;
+    }
+    outW = bmp.width();
+    outH = bmp.height();
+    rgba.assign(bmp.data(), bmp.data() + outW * outH * 4);
+    return true;
+  }
+
+  int sw = 0, sh = 0, channels = 0;
+  stbi_set_flip_vertically_on_load(false);
+  unsigned char *pixels = stbi_load(path.c_str(), &sw, &sh, &channels, 4);
+  if (!pixels) {
+    std::cerr << "Failed to load raster image: " << path << std::endl;
+    return false;
+  }
+  outW = w > 0 ? w : sw;
+  outH = h > 0 ? h : sh;
+  rgba.resize(outW * outH * 4);
+  if (outW == sw && outH == sh)
+    std::copy(pixels, pixels + rgba.size(), rgba.begin());
+  else
+    boxResize(pixels, sw, sh, rgba.data(), outW, outH);
+  stbi_image_free(pixels);
+  return true;
+}
+
+// glTexStorage3D is GL 4.2 and the context is 3.3, so level 0 is allocated
+// with glTexImage3D and glGenerateMipmap builds the rest.
+GLuint loadTextureArray(const std::vector<std::string> &paths, int size) {
+  int layers = (int)paths.size();
+
+  GLuint tex = 0;
+  glGenTextures(1, &tex);
+  glState.bindTexture(GL_TEXTURE_2D_ARRAY, tex);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, size, size, layers, 0,
+               GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+                  GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  std::vector<unsigned char> layer;
+  for (int i = 0; i < layers; ++i) {
+    int w = 0, h = 0;
+    if (!loadImage(paths[i], size, size, layer, w, h))
+      layer.assign(size * size * 4, 0);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, size, size, 1, GL_RGBA,
+                    GL_UNSIGNED_BYTE, layer.data());
+  }
+  glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+  return tex;
+}
@@ -31,6 +31,11 @@ bool Window::init() {
   }
 
   glfwMakeContextCurrent(handle);
+  glfwSetWindowUserPointer(handle, this);
+  glfwSetWindowRefreshCallback(handle, [](GLFWwindow *w) {
+    static_cast<Window *>(glfwGetWindowUserPointer(w))->refreshRequested =
+        true;
+  });
 
   if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
     std::cerr << "Failed to initialize GLAD" << std::endl;
@@ -47,9 +52,13 @@ bool Window::init() {
   return true;
 }
 
-void Window::update() {
-  glfwSwapBuffers(handle);
-  glfwPollEvents();
+void Window::present() { glfwSwapBuffers(handle); }
+
+void Window::waitEvents(double timeout) {
+  if (timeout < 0.0)
+    glfwWaitEvents();
+  else
+    glfwWaitEventsTimeout(timeout);
 
   glfwGetWindowSize(handle, &width, &height);
 
@@ -58,6 +67,12 @@ void Window::update() {
   glViewport(0, 0, fbW, fbH);
 }
 
+bool Window::takeRefreshRequest() {
+  bool requested = refreshRequested;
+  refreshRequested = false;
+  return requested;
+}
+
 void Window::close() { glfwSetWindowShouldClose(handle, true); }
 
 bool Window::shouldClose() const { return glfwWindowShouldClose(handle); }
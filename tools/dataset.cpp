@@ -0,0 +1,250 @@
+#include "../include/solver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes training positions as fixed-layout binary shards, one shard per
+// worker thread. Workers play seeded games with the frontier solver and
+// record every position before a move is made: the visible board, the true
+// mine layout and the solver's mine probabilities.
+//
+// Shard layout, little-endian:
+//   ShardHeader (64 bytes)
+//   records, recordSize bytes each:
+//     u64 seed, u32 move number, u32 reserved
+//     cells bytes    visible board as Board::code()
+//     (cells+7)/8    mine mask, bit i of byte i/8 set for a mine
+//     cells bytes    mine probability * 255, 0 for revealed or flagged
+//   index at indexOffset: one IndexEntry per game; truncated is 1 for the
+//   last game if the shard filled up before it ended, so its won is not a
+//   result
+// The header is rewritten with the final counts once the shard is complete.
+
+#pragma pack(push, 1)
+struct ShardHeader {
+  char magic[4];
+  uint32_t version;
+  uint16_t rows, cols, mines, reserved;
+  uint32_t recordSize;
+  uint64_t recordCount;
+  uint64_t gameCount;
+  uint64_t indexOffset;
+  uint8_t padding[20];
+};
+
+struct IndexEntry {
+  uint64_t seed;
+  uint64_t firstRecord;
+  uint32_t recordCount;
+  uint8_t won;
+  uint8_t truncated;
+  uint8_t reserved[2];
+};
+#pragma pack(pop)
+static_assert(sizeof(ShardHeader) == 64, "ShardHeader must stay 64 bytes");
+static_assert(sizeof(IndexEntry) == 24, "IndexEntry must stay 24 bytes");
+
+static const size_t kFlushBytes = 8u << 20;
+// Keeps cell indices in int and the record size in uint32_t.
+static const int64_t kMaxCells = 1 << 24;
+// A game won on the first reveal records nothing; this many in a row means
+// the configuration cannot produce positions.
+static const int kMaxEmptyGames = 1000;
+
+static uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+class ShardWriter {
+public:
+  ~ShardWriter() {
+    if (file)
+      std::fclose(file);
+  }
+
+  bool open(const std::string &path, const ShardHeader &h) {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+      std::fprintf(stderr, "dataset: cannot open %s\n", path.c_str());
+      return false;
+    }
+    header = h;
+    buffer.reserve(kFlushBytes + h.recordSize);
+    return std::fwrite(&header, sizeof(header), 1, file) == 1;
+  }
+
+  uint8_t *beginRecord() {
+    size_t at = buffer.size();
+    buffer.resize(at + header.recordSize);
+    header.recordCount++;
+    return buffer.data() + at;
+  }
+
+  bool endRecord() { return buffer.size() < kFlushBytes || flush(); }
+
+  bool finish(const std::vector<IndexEntry> &index) {
+    if (!flush())
+      return false;
+    header.gameCount = index.size();
+    header.indexOffset =
+        sizeof(ShardHeader) + header.recordCount * header.recordSize;
+    if (std::fwrite(index.data(), sizeof(IndexEntry), index.size(), file) !=
+            index.size() ||
+        std::fseek(file, 0, SEEK_SET) != 0 ||
+        std::fwrite(&header, sizeof(header), 1, file) != 1)
+      return false;
+    FILE *f = file;
+    file = nullptr;
+    return std::fclose(f) == 0;
+  }
+
+  uint64_t records() const { return header.recordCount; }
+
+private:
+  bool flush() {
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), file) ==
+              buffer.size();
+    buffer.clear();
+    return ok;
+  }
+
+  FILE *file = nullptr;
+  ShardHeader header;
+  std::vector<uint8_t> buffer;
+};
+
+static bool writeShard(const std::string &path, int rows, int cols,
+                       int mines, uint64_t target, uint64_t seed) {
+  int cells = rows * cols;
+  ShardHeader h{};
+  std::memcpy(h.magic, "MSDS", 4);
+  h.version = 2;
+  h.rows = (uint16_t)rows;
+  h.cols = (uint16_t)cols;
+  h.mines = (uint16_t)mines;
+  h.recordSize = (uint32_t)(16 + cells + (cells + 7) / 8 + cells);
+
+  ShardWriter writer;
+  if (!writer.open(path, h))
+    return false;
+
+  SampleOptions noSampling;
+  noSampling.deadlineMs = 0.0;
+  Solver solver(200000);
+  solver.setSampleOptions(noSampling);
+  SolveResult res;
+  std::vector<IndexEntry> index;
+  Board board;
+  int emptyGames = 0;
+
+  for (uint64_t game = 0; writer.records() < target; ++game) {
+    IndexEntry entry{};
+    entry.seed = splitmix64(seed + game);
+    entry.firstRecord = writer.records();
+    board.reset(rows, cols, mines, entry.seed);
+    board.reveal((rows / 2) * cols + cols / 2);
+    solver.clearCache();
+
+    uint32_t move = 0;
+    while (board.getState() == GameState::PLAYING &&
+           writer.records() < target) {
+      BoardView view = BoardView::of(board);
+      solver.solve(view, res);
+
+      uint8_t *rec = writer.beginRecord();
+      std::memcpy(rec, &entry.seed, 8);
+      std::memcpy(rec + 8, &move, 4);
+      std::memset(rec + 12, 0, 4);
+      uint8_t *visible = rec + 16;
+      uint8_t *mask = visible + cells;
+      uint8_t *prob = mask + (cells + 7) / 8;
+      std::memset(mask, 0, (cells + 7) / 8);
+      for (int i = 0; i < cells; ++i) {
+        visible[i] = board.code(i);
+        if (board.at(i).mine)
+          mask[i >> 3] |= (uint8_t)(1u << (i & 7));
+        float p = res.mineProbability[i];
+        prob[i] = p < 0.0f ? 0 : (uint8_t)(p * 255.0f + 0.5f);
+      }
+      if (!writer.endRecord())
+        return false;
+      move++;
+
+      if (!res.safeCells.empty() || !res.mineCells.empty()) {
+        for (int c : res.mineCells)
+          if (!board.at(c).flagged)
+            board.toggleFlag(c);
+        for (int c : res.safeCells)
+          board.reveal(c);
+      } else if (res.bestGuess >= 0) {
+        board.reveal(res.bestGuess);
+      } else {
+        break;
+      }
+    }
+    entry.recordCount = (uint32_t)(writer.records() - entry.firstRecord);
+    entry.won = board.getState() == GameState::WON;
+    entry.truncated = board.getState() == GameState::PLAYING &&
+                      writer.records() >= target;
+    index.push_back(entry);
+    emptyGames = entry.recordCount ? 0 : emptyGames + 1;
+    if (emptyGames >= kMaxEmptyGames) {
+      std::fprintf(stderr,
+                   "dataset: %s: %d games in a row gave no positions\n",
+                   path.c_str(), kMaxEmptyGames);
+      return false;
+    }
+  }
+  return writer.finish(index);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 6) {
+    std::fprintf(stderr, "usage: dataset outDir rows cols mines positions "
+                         "[threads] [seed]\n");
+    return 1;
+  }
+  std::string dir = argv[1];
+  int rows = std::atoi(argv[2]), cols = std::atoi(argv[3]);
+  int mines = std::atoi(argv[4]);
+  uint64_t positions = std::strtoull(argv[5], nullptr, 10);
+  int threads = argc > 6 ? std::atoi(argv[6]) : 0;
+  uint64_t seed = argc > 7 ? std::strtoull(argv[7], nullptr, 10) : 1;
+  if (threads <= 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  if (rows <= 0 || cols <= 0 || rows > 65535 || cols > 65535 ||
+      (int64_t)rows * cols > kMaxCells) {
+    std::fprintf(stderr, "dataset: invalid board size\n");
+    return 1;
+  }
+  // Board::generate keeps the 3x3 around the first reveal clear.
+  if (mines < 1 || mines > 65535 ||
+      (int64_t)mines > (int64_t)rows * cols - 9) {
+    std::fprintf(stderr, "dataset: mines must be between 1 and rows*cols-9\n");
+    return 1;
+  }
+
+  std::atomic<int> failed{0};
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; ++t) {
+    uint64_t share = positions / threads + (t < (int)(positions % threads));
+    pool.emplace_back([&, t, share]() {
+      char name[32];
+      std::snprintf(name, sizeof(name), "/shard-%03d.bin", t);
+      uint64_t shardSeed = splitmix64(seed ^ ((uint64_t)t << 40));
+      if (!writeShard(dir + name, rows, cols, mines, share, shardSeed))
+        failed++;
+    });
+  }
+  for (auto &t : pool)
+    t.join();
+  return failed ? 1 : 0;
+}
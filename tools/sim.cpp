@@ -0,0 +1,404 @@
+#include "../include/bot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <dirent.h>
+#include <fstream>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Plays complete games with the built-in bot on a work-stealing pool. Games
+// are split into chunks dealt round-robin to per-worker deques; a worker
+// takes chunks from the back of its own deque and, once that is empty,
+// steals from the front of the others. Each worker owns its Board, Bot and
+// RNG, and results are summed into relaxed atomic counters. Game i always
+// gets the same board seed and the same guess tie-break stream, whichever
+// worker plays it, so win rates do not depend on the thread count.
+//
+// With --affinity compact (fill one NUMA node before the next) or scatter
+// (round-robin over nodes), each worker is pinned before it builds its
+// engine state, so that memory is first touched, and therefore placed, on
+// the worker's own node. Nodes come from /sys/devices/system/node; without
+// it every allowed CPU counts as node 0.
+
+using Clock = std::chrono::steady_clock;
+
+struct Level {
+  const char *name;
+  int rows, cols, mines;
+};
+
+static const Difficulty kDifficulties[] = {
+    Difficulty::BEGINNER, Difficulty::INTERMEDIATE, Difficulty::EXPERT};
+
+// The game's own difficulties, so win rates are for the boards players get.
+static Level gameLevel(Difficulty d) {
+  const DifficultyLevel &level = difficultyLevel(d);
+  return {level.name, level.rows, level.cols,
+          Board::defaultMineCount(level.rows, level.cols)};
+}
+
+static const long kChunk = 16;
+// Keeps a game's tie-break stream apart from its board seed.
+static const uint64_t kBotSalt = 0x6a09e667f3bcc908ULL;
+
+static uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+struct Range {
+  long begin, end;
+};
+
+enum class Affinity { NONE, COMPACT, SCATTER };
+
+// cpu < 0 leaves the worker unpinned; its node is then looked up from the
+// CPU it happens to be on when it reports.
+struct Placement {
+  int cpu = -1;
+  int node = 0;
+};
+
+static std::vector<int> parseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  const char *p = list.c_str();
+  while (*p) {
+    char *end;
+    long a = std::strtol(p, &end, 10);
+    if (end == p)
+      break;
+    long b = a;
+    p = end;
+    if (*p == '-') {
+      b = std::strtol(p + 1, &end, 10);
+      p = end;
+    }
+    for (long c = a; c <= b; ++c)
+      cpus.push_back((int)c);
+    if (*p == ',')
+      p++;
+  }
+  return cpus;
+}
+
+// CPUs this process may run on, grouped by NUMA node.
+static std::vector<std::vector<int>> detectNodes() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+  auto usable = [&](int cpu) {
+    return !haveMask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed));
+  };
+
+  std::vector<std::vector<int>> nodes;
+  if (DIR *dir = opendir("/sys/devices/system/node")) {
+    std::vector<int> ids;
+    while (dirent *e = readdir(dir)) {
+      int id;
+      if (std::sscanf(e->d_name, "node%d", &id) == 1)
+        ids.push_back(id);
+    }
+    closedir(dir);
+    std::sort(ids.begin(), ids.end());
+    for (int id : ids) {
+      std::ifstream in("/sys/devices/system/node/node" + std::to_string(id) +
+                       "/cpulist");
+      std::string list;
+      std::getline(in, list);
+      std::vector<int> cpus;
+      for (int c : parseCpuList(list))
+        if (usable(c))
+          cpus.push_back(c);
+      if (!cpus.empty())
+        nodes.push_back(cpus);
+    }
+  }
+  if (nodes.empty()) {
+    std::vector<int> cpus;
+    for (int c = 0; c < CPU_SETSIZE; ++c)
+      if (haveMask && CPU_ISSET(c, &allowed))
+        cpus.push_back(c);
+    nodes.push_back(cpus);
+  }
+  return nodes;
+}
+
+static std::vector<Placement>
+placeWorkers(int workers, Affinity policy,
+             const std::vector<std::vector<int>> &nodes) {
+  std::vector<Placement> out(workers);
+  if (policy == Affinity::NONE)
+    return out;
+  std::vector<int> nodeCpu, nodeIdx;
+  for (size_t n = 0; n < nodes.size(); ++n)
+    for (int c : nodes[n]) {
+      nodeCpu.push_back(c);
+      nodeIdx.push_back((int)n);
+    }
+  if (nodeCpu.empty())
+    return out;
+  int total = (int)nodeCpu.size();
+  int nodeCount = (int)nodes.size();
+  for (int w = 0; w < workers; ++w) {
+    if (policy == Affinity::COMPACT) {
+      out[w].cpu = nodeCpu[w % total];
+      out[w].node = nodeIdx[w % total];
+    } else {
+      int n = w % nodeCount;
+      const std::vector<int> &cpus = nodes[n];
+      out[w].cpu = cpus[(w / nodeCount) % cpus.size()];
+      out[w].node = n;
+    }
+  }
+  return out;
+}
+
+static bool pinCurrentThread(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+class WorkStealingPool {
+public:
+  WorkStealingPool(int workers, long jobs) : queues(workers) {
+    int w = 0;
+    for (long b = 0; b < jobs; b += kChunk) {
+      queues[w].chunks.push_back({b, std::min(jobs, b + kChunk)});
+      w = (w + 1) % workers;
+    }
+  }
+
+  bool take(int self, Range &out) {
+    if (queues[self].popBack(out))
+      return true;
+    int n = (int)queues.size();
+    for (int i = 1; i < n; ++i)
+      if (queues[(self + i) % n].popFront(out)) {
+        steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    return false;
+  }
+
+  long getSteals() const { return steals.load(); }
+
+private:
+  struct Queue {
+    std::mutex lock;
+    std::deque<Range> chunks;
+
+    bool popBack(Range &out) {
+      std::lock_guard<std::mutex> guard(lock);
+      if (chunks.empty())
+        return false;
+      out = chunks.back();
+      chunks.pop_back();
+      return true;
+    }
+    bool popFront(Range &out) {
+      std::lock_guard<std::mutex> guard(lock);
+      if (chunks.empty())
+        return false;
+      out = chunks.front();
+      chunks.pop_front();
+      return true;
+    }
+  };
+
+  std::vector<Queue> queues;
+  std::atomic<long> steals{0};
+};
+
+struct SimStats {
+  std::atomic<long> games{0};
+  std::atomic<long> wins{0};
+  std::atomic<long> steals{0};
+  std::atomic<int> pinFailures{0};
+  // Per-node game counts, each on its own cache line.
+  struct alignas(64) NodeCount {
+    std::atomic<long> games{0};
+  };
+  std::vector<NodeCount> perNode;
+  double seconds = 0.0;
+};
+
+static void simulate(const Level &level, long games, int threads,
+                     Bot::Policy policy, uint64_t seed,
+                     const std::vector<Placement> &placement,
+                     const std::vector<int> &cpuNode, int nodeCount,
+                     SimStats &stats) {
+  WorkStealingPool pool(threads, games);
+  stats.perNode = std::vector<SimStats::NodeCount>(nodeCount);
+  auto nodeNow = [&](const Placement &place) {
+    if (place.cpu >= 0)
+      return place.node;
+    int cpu = sched_getcpu();
+    return cpu >= 0 && cpu < (int)cpuNode.size() ? cpuNode[cpu] : 0;
+  };
+  auto worker = [&](int self) {
+    const Placement &place = placement[self];
+    if (place.cpu >= 0 && !pinCurrentThread(place.cpu))
+      stats.pinFailures++;
+    // Built after pinning so their memory is first touched on this node.
+    Board board;
+    Bot bot(policy);
+    std::mt19937_64 rng;
+    Range range;
+    long played = 0, won = 0;
+    while (pool.take(self, range)) {
+      for (long g = range.begin; g < range.end; ++g) {
+        board.reset(level.rows, level.cols, level.mines,
+                    splitmix64(seed + (uint64_t)g));
+        board.reveal((level.rows / 2) * level.cols + level.cols / 2);
+        rng.seed(splitmix64(seed + (uint64_t)g) ^ kBotSalt);
+        won += bot.play(board, rng);
+        played++;
+      }
+      stats.games.fetch_add(played, std::memory_order_relaxed);
+      stats.wins.fetch_add(won, std::memory_order_relaxed);
+      stats.perNode[nodeNow(place)].games.fetch_add(
+          played, std::memory_order_relaxed);
+      played = won = 0;
+    }
+  };
+
+  auto t0 = Clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back(worker, t);
+  for (auto &t : workers)
+    t.join();
+  stats.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+  stats.steals = pool.getSteals();
+}
+
+static bool isLevelName(const char *s) {
+  for (Difficulty d : kDifficulties)
+    if (std::strcmp(s, difficultyLevel(d).name) == 0)
+      return true;
+  return false;
+}
+
+static bool parsePolicy(const char *s, Bot::Policy &out) {
+  if (std::strcmp(s, "local") == 0)
+    out = Bot::Policy::LOCAL;
+  else if (std::strcmp(s, "solver") == 0)
+    out = Bot::Policy::SOLVER;
+  else if (std::strcmp(s, "expectimax") == 0)
+    out = Bot::Policy::EXPECTIMAX;
+  else
+    return false;
+  return true;
+}
+
+static bool parseAffinity(const char *s, Affinity &out) {
+  if (std::strcmp(s, "compact") == 0)
+    out = Affinity::COMPACT;
+  else if (std::strcmp(s, "scatter") == 0)
+    out = Affinity::SCATTER;
+  else if (std::strcmp(s, "none") == 0)
+    out = Affinity::NONE;
+  else
+    return false;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  long games = 10000;
+  int threads = 0;
+  uint64_t seed = 1;
+  Bot::Policy policy = Bot::Policy::SOLVER;
+  Affinity affinity = Affinity::NONE;
+  const char *only = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+      games = std::atol(argv[++i]);
+    } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc &&
+               isLevelName(argv[i + 1])) {
+      only = argv[++i];
+    } else if (std::strcmp(argv[i], "--policy") == 0 && i + 1 < argc &&
+               parsePolicy(argv[i + 1], policy)) {
+      ++i;
+    } else if (std::strcmp(argv[i], "--affinity") == 0 && i + 1 < argc &&
+               parseAffinity(argv[i + 1], affinity)) {
+      ++i;
+    } else {
+      std::fprintf(stderr,
+                   "usage: minesweeper-sim [--games N] [--threads T] "
+                   "[--seed S] [--level beginner|intermediate|expert] "
+                   "[--policy local|solver|expectimax] "
+                   "[--affinity compact|scatter|none]\n");
+      return 1;
+    }
+  }
+  if (threads <= 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  if (games <= 0)
+    return 0;
+
+  std::vector<std::vector<int>> nodes = detectNodes();
+  std::vector<Placement> placement = placeWorkers(threads, affinity, nodes);
+  std::vector<Placement> singlePlacement(1, placement[0]);
+  int nodeCount = (int)nodes.size();
+  std::vector<int> cpuNode(CPU_SETSIZE, 0);
+  for (int n = 0; n < nodeCount; ++n)
+    for (int c : nodes[n])
+      if (c < CPU_SETSIZE)
+        cpuNode[c] = n;
+  std::printf("%d NUMA node(s), affinity %s\n", nodeCount,
+              affinity == Affinity::COMPACT   ? "compact"
+              : affinity == Affinity::SCATTER ? "scatter"
+                                              : "none");
+
+  std::printf("%-13s %8s %8s %10s %12s %10s %7s\n", "level", "games",
+              "win%", "games/s", "games/s/core", "efficiency", "steals");
+  for (Difficulty d : kDifficulties) {
+    Level level = gameLevel(d);
+    if (only && std::strcmp(only, level.name) != 0)
+      continue;
+
+    SimStats stats;
+    simulate(level, games, threads, policy, seed, placement, cpuNode,
+             nodeCount, stats);
+    double rate = stats.games / stats.seconds;
+
+    // Efficiency compares against one thread doing one thread's share.
+    double efficiency = 1.0;
+    if (threads > 1) {
+      SimStats single;
+      simulate(level, std::max(1L, games / threads), 1, policy, seed,
+               singlePlacement, cpuNode, nodeCount, single);
+      efficiency = rate / (threads * (single.games / single.seconds));
+    }
+    std::printf("%-13s %8ld %7.2f%% %10.0f %12.0f %10.2f %7ld\n", level.name,
+                stats.games.load(), 100.0 * stats.wins / stats.games, rate,
+                rate / threads, efficiency, stats.steals.load());
+    if (stats.pinFailures)
+      std::printf("  %d worker(s) could not be pinned\n",
+                  stats.pinFailures.load());
+    if (nodeCount > 1 || affinity != Affinity::NONE) {
+      for (int n = 0; n < nodeCount; ++n) {
+        std::printf("  node %d: %.0f games/s\n", n,
+                    stats.perNode[n].games / stats.seconds);
+      }
+    }
+  }
+  return 0;
+}
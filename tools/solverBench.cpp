@@ -0,0 +1,133 @@
+#include "../include/satBackend.hpp"
+#include "../include/solver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+// Compares exhaustive enumeration with the SAT backend at deciding forced
+// cells. The corpus is fixed: every position where the solver has no safe
+// move, on the game's EXPERT boards seeded 1..N, played on by revealing the
+// lowest-probability safe cell so that late, interlocked endgames are
+// included.
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+static std::vector<BoardView> buildCorpus(int boards, int rows, int cols,
+                                          int mines) {
+  std::vector<BoardView> corpus;
+  SampleOptions noSampling;
+  noSampling.deadlineMs = 0.0;
+  Solver solver;
+  solver.setSampleOptions(noSampling);
+  solver.setSatConflictBudget(0);
+
+  for (int seed = 1; seed <= boards; ++seed) {
+    Board board;
+    board.reset(rows, cols, mines, (uint64_t)seed);
+    board.reveal((rows / 2) * cols + cols / 2);
+    SolveResult res;
+    while (board.getState() == GameState::PLAYING) {
+      BoardView view = BoardView::of(board);
+      solver.solve(view, res);
+      if (!res.safeCells.empty()) {
+        for (int c : res.safeCells)
+          board.reveal(c);
+        continue;
+      }
+      corpus.push_back(view);
+
+      int pick = -1;
+      for (int i = 0; i < board.size(); ++i) {
+        if (view.cells[i] != CELL_UNKNOWN || board.at(i).mine)
+          continue;
+        if (pick < 0 || res.mineProbability[i] < res.mineProbability[pick])
+          pick = i;
+      }
+      if (pick < 0)
+        break;
+      board.reveal(pick);
+    }
+  }
+  return corpus;
+}
+
+int main(int argc, char **argv) {
+  int boards = argc > 1 ? std::atoi(argv[1]) : 20;
+  const DifficultyLevel &expert = difficultyLevel(Difficulty::EXPERT);
+  std::vector<BoardView> corpus =
+      buildCorpus(boards, expert.rows, expert.cols,
+                  Board::defaultMineCount(expert.rows, expert.cols));
+
+  SampleOptions noSampling;
+  noSampling.deadlineMs = 0.0;
+  Solver enumerator(1L << 40);
+  enumerator.setSampleOptions(noSampling);
+
+  double enumMs = 0.0, satMs = 0.0, enumWorst = 0.0, satWorst = 0.0;
+  long conflicts = 0;
+  int mismatches = 0;
+  for (const BoardView &view : corpus) {
+    enumerator.clearCache();
+    SolveResult res;
+    auto t0 = Clock::now();
+    enumerator.solve(view, res);
+    double e = msSince(t0);
+
+    SatForced forced;
+    t0 = Clock::now();
+    SatBackend::findForced(view, {}, forced);
+    double s = msSince(t0);
+
+    enumMs += e;
+    satMs += s;
+    enumWorst = std::max(enumWorst, e);
+    satWorst = std::max(satWorst, s);
+    conflicts += forced.conflicts;
+
+    // Enumeration also reports interior cells; compare on the frontier only.
+    std::vector<int> enumSafe, enumMines;
+    std::vector<bool> onFrontier(view.cells.size(), false);
+    for (int c : forced.safeCells)
+      onFrontier[c] = true;
+    for (int c : forced.mineCells)
+      onFrontier[c] = true;
+    for (int i = 0; i < (int)view.cells.size(); ++i) {
+      if (view.cells[i] < 0)
+        continue;
+      int r = i / view.cols, c = i % view.cols;
+      for (int dr = -1; dr <= 1; ++dr)
+        for (int dc = -1; dc <= 1; ++dc) {
+          int nr = r + dr, nc = c + dc;
+          if (nr >= 0 && nr < view.rows && nc >= 0 && nc < view.cols &&
+              view.cells[nr * view.cols + nc] == CELL_UNKNOWN)
+            onFrontier[nr * view.cols + nc] = true;
+        }
+    }
+    for (int c : res.safeCells)
+      if (onFrontier[c])
+        enumSafe.push_back(c);
+    for (int c : res.mineCells)
+      if (onFrontier[c])
+        enumMines.push_back(c);
+    std::sort(enumSafe.begin(), enumSafe.end());
+    std::sort(enumMines.begin(), enumMines.end());
+    std::sort(forced.safeCells.begin(), forced.safeCells.end());
+    std::sort(forced.mineCells.begin(), forced.mineCells.end());
+    if (enumSafe != forced.safeCells || enumMines != forced.mineCells)
+      mismatches++;
+  }
+
+  std::printf("positions       %zu\n", corpus.size());
+  std::printf("enumeration     %.2f ms total, %.3f ms worst\n", enumMs,
+              enumWorst);
+  std::printf("sat             %.2f ms total, %.3f ms worst, %ld conflicts\n",
+              satMs, satWorst, conflicts);
+  std::printf("disagreements   %d\n", mismatches);
+  return mismatches == 0 ? 0 : 1;
+}